@@ -6,13 +6,9 @@
 #include <regex>
 #include <iomanip>
 
-struct Point {
-    float x, y;
-};
+#include "../src/maze_structs.h"
 
-struct Polygon {
-    std::vector<Point> points;
-};
+using Point = MazeCoordinate;
 
 struct SolutionPath {
     std::vector<Point> nodes;
@@ -20,7 +16,7 @@ struct SolutionPath {
 
 class HtmlImageMapConverter {
 private:
-    std::vector<Polygon> polygons;
+    PolygonStore polygons;
     std::vector<SolutionPath> solutionPaths;
     
     // Parse coordinates string like "493,729,591,820,644,885,..."
@@ -73,9 +69,7 @@ private:
                 if (!points.empty()) {
                     if (shape == "poly") {
                         // This is a polygon
-                        Polygon poly;
-                        poly.points = points;
-                        polygons.push_back(poly);
+                        polygons.addPolygon(points.data(), points.size());
                     } else if (shape.empty()) {
                         // This is a solution path (empty shape)
                         SolutionPath path;
@@ -89,6 +83,24 @@ private:
         file.close();
     }
     
+    // Build the solution graph, every path is a closed loop so each node is
+    // connected to its previous and next node
+    SolutionGraph buildSolutionGraph() const {
+        SolutionGraph graph;
+        uint64_t pathStart = 0;
+        for (const SolutionPath& path : solutionPaths) {
+            uint64_t count = static_cast<uint64_t>(path.nodes.size());
+            for (uint64_t i = 0; i < count; ++i) {
+                graph.addNode(path.nodes[i]);
+                graph.addNeighbor(pathStart + (i == 0 ? count - 1 : i - 1));
+                graph.addNeighbor(pathStart + (i == count - 1 ? 0 : i + 1));
+                graph.closeNode();
+            }
+            pathStart += count;
+        }
+        return graph;
+    }
+    
     // Generate C++ code
     void generateCppCode(const std::string& outputFilename) {
         std::ofstream outFile(outputFilename);
@@ -110,82 +122,60 @@ private:
         // Set fixed precision for float output
         outFile << std::fixed << std::setprecision(1);
         
-        // Generate polygons
+        // Generate polygons as one flat coordinate array plus offsets
+        outFile << "    static const MazeCoordinate polygonCoordinates[] = {\n";
         for (size_t i = 0; i < polygons.size(); ++i) {
-            outFile << "    // Polygon " << (i + 1) << "\n";
-            outFile << "    std::vector<MazeCoordinate> coords" << (i + 1) << " = {\n";
+            const CoordinateSpan points = polygons[i].coordinates;
+            outFile << "        // Polygon " << (i + 1) << "\n";
             
-            for (size_t j = 0; j < polygons[i].points.size(); ++j) {
+            for (size_t j = 0; j < points.size(); ++j) {
                 outFile << "        {" << std::fixed << std::setprecision(1) 
-                        << polygons[i].points[j].x << "f, " 
-                        << polygons[i].points[j].y << "f}";
+                        << points[j].x << "f, " 
+                        << points[j].y << "f},";
                 
-                if (j == 0) outFile << ",  // start";
-                else if (j == polygons[i].points.size() - 1) outFile << "   // end";
-                else outFile << ",";
+                if (j == 0) outFile << "  // start";
+                else if (j == points.size() - 1) outFile << "  // end";
                 
                 outFile << "\n";
             }
-            
-            outFile << "    };\n\n";
-            
-            outFile << "    Mazepolygon poly" << (i + 1) << ";\n";
-            outFile << "    for (const auto& coord : coords" << (i + 1) << ") {\n";
-            outFile << "        poly" << (i + 1) << ".coordinates.push_back(coord);\n";
-            outFile << "    }\n\n";
-            outFile << "    polygons.push_back(poly" << (i + 1) << ");\n\n";
         }
+        outFile << "    };\n";
+        
+        outFile << "    static const uint64_t polygonOffsets[] = {";
+        for (uint64_t offset : polygons.offsets()) {
+            outFile << offset << ", ";
+        }
+        outFile << "};\n";
+        outFile << "    polygons.assign(polygonCoordinates, " << polygons.coordinates().size()
+                << ", polygonOffsets, " << polygons.size() << ");\n\n";
         
-        // Generate solution graph nodes
-        int nodeCounter = 1;
+        // Generate solution graph as node, offset and neighbour arrays
+        SolutionGraph graph = buildSolutionGraph();
+        outFile << "    static const MazeCoordinate nodeCoordinates[] = {\n";
+        size_t pathStart = 0;
         for (size_t pathIdx = 0; pathIdx < solutionPaths.size(); ++pathIdx) {
-            outFile << "    // Solution path " << (pathIdx + 1) << " nodes\n";
-            
-            std::vector<int> pathNodeNumbers;
-            
-            // Create all nodes for this path
-            for (size_t nodeIdx = 0; nodeIdx < solutionPaths[pathIdx].nodes.size(); ++nodeIdx) {
-                const Point& node = solutionPaths[pathIdx].nodes[nodeIdx];
-                
-                outFile << "    SolutionGraphNode node" << nodeCounter << ";\n";
-                outFile << "    node" << nodeCounter << ".coordinate = {" 
-                        << std::fixed << std::setprecision(1)
-                        << node.x << "f, " << node.y << "f};\n";
-                
-                pathNodeNumbers.push_back(nodeCounter);
-                nodeCounter++;
+            outFile << "        // Solution path " << (pathIdx + 1) << " nodes\n";
+            for (size_t n = pathStart; n < pathStart + solutionPaths[pathIdx].nodes.size(); ++n) {
+                outFile << "        {" << std::fixed << std::setprecision(1)
+                        << graph.coordinate(n).x << "f, " << graph.coordinate(n).y << "f},\n";
             }
-            
-            outFile << "\n";
-            
-            // Add all nodes to the solution graph
-            for (int nodeNum : pathNodeNumbers) {
-                outFile << "    solutionGraph.push_back(node" << nodeNum << ");\n";
-            }
-            
-            outFile << "\n";
-            
-            // Set up neighbors for each node in the path (continuous loop)
-            for (size_t nodeIdx = 0; nodeIdx < pathNodeNumbers.size(); ++nodeIdx) {
-                int currentNodeNum = pathNodeNumbers[nodeIdx];
-                
-                outFile << "    // Setting neighbors for node" << currentNodeNum << "\n";
-                
-                // Add previous node as neighbor (with loop wrapping)
-                size_t prevIdx = (nodeIdx == 0) ? pathNodeNumbers.size() - 1 : nodeIdx - 1;
-                int prevNodeNum = pathNodeNumbers[prevIdx];
-                outFile << "    node" << currentNodeNum 
-                        << ".neighbors.push_back(&node" << prevNodeNum << ");\n";
-                
-                // Add next node as neighbor (with loop wrapping)
-                size_t nextIdx = (nodeIdx == pathNodeNumbers.size() - 1) ? 0 : nodeIdx + 1;
-                int nextNodeNum = pathNodeNumbers[nextIdx];
-                outFile << "    node" << currentNodeNum 
-                        << ".neighbors.push_back(&node" << nextNodeNum << ");\n";
-            }
-            
-            outFile << "\n";
+            pathStart += solutionPaths[pathIdx].nodes.size();
+        }
+        outFile << "    };\n";
+        
+        outFile << "    static const uint64_t nodeOffsets[] = {";
+        for (size_t n = 0; n < graph.offsets().size(); ++n) {
+            outFile << (n % 16 == 0 ? "\n        " : "") << graph.offsets()[n] << ", ";
+        }
+        outFile << "\n    };\n";
+        
+        outFile << "    static const uint64_t nodeNeighbors[] = {";
+        for (size_t n = 0; n < graph.neighborIndices().size(); ++n) {
+            outFile << (n % 16 == 0 ? "\n        " : "") << graph.neighborIndices()[n] << ", ";
         }
+        outFile << "\n    };\n";
+        outFile << "    solutionGraph.assign(nodeCoordinates, " << graph.size() << ", nodeOffsets, nodeNeighbors, "
+                << graph.neighborIndices().size() << ");\n";
         
         outFile << "}\n";
         outFile.close();
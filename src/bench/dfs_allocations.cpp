@@ -0,0 +1,60 @@
+/**
+ * Microbenchmark for the depth-first search inner loop.
+ *
+ * Replaces the global operator new of this program with a counting one and
+ * runs the search on growing grids. The grid and the backtracking path are
+ * allocated before the search starts; the search itself must not allocate,
+ * so the reported allocations per step have to be 0.
+ *
+ * Build and run from the src directory:
+ *   g++ -std=c++17 -O2 -pthread bench/dfs_allocations.cpp -o dfs_allocations
+ *   ./dfs_allocations [max grid size]
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include "../maze_algorithms.h"
+#include "../maze_grid.h"
+#include "../random.h"
+
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+// not inlined, GCC would flag the free() of memory from operator new otherwise
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char* argv[]) {
+    const int maxSize = argc > 1 ? std::stoi(argv[1]) : 4000;
+    bool allocationFree = true;
+    std::cout << std::fixed << std::setprecision(2);
+    for (GridLayout layout : {GridLayout::RowMajor, GridLayout::Morton}) {
+        for (int size = 100; size <= maxSize; size *= 4) {
+            MazeGrid maze(size, size, layout);
+            const MazeRegion region{0, 0, size, size};
+            DepthFirstState state(maze, region);
+            Xoshiro256 rng(42);
+            const size_t before = allocationCount.load();
+            auto start = std::chrono::steady_clock::now();
+            runDepthFirst(maze, rng, state, [] { return true; });
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            const size_t allocations = allocationCount.load() - before;
+            // every cell is entered once and left once
+            const double steps = 2.0 * size * size;
+            allocationFree = allocationFree && allocations == 0;
+            std::cout << (layout == GridLayout::Morton ? "morton    " : "row-major ") << std::setw(6) << size << "  "
+                      << std::setw(9) << ms << " ms  " << std::setw(6) << steps / ms / 1000.0 << " Msteps/s  "
+                      << allocations << " allocations (" << allocations / steps << " per step)\n";
+        }
+    }
+    std::cout << (allocationFree ? "ok: no allocations in the search loop" : "FAILED: the search loop allocates") << std::endl;
+    return allocationFree ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+/**
+ * Binary checkpoint files for long running generations.
+ *
+ * A checkpoint starts with a magic number, the format version and a key
+ * describing the run (command line parameters), followed by the phase and
+ * whatever state that phase needs. Values are stored in native byte order,
+ * a checkpoint is meant to be resumed by the same build on the same machine.
+ */
+
+// the stage a checkpoint was taken in
+enum CheckpointPhase : uint32_t {
+    CHECKPOINT_GENERATION = 1, // depth-first search running
+    CHECKPOINT_OUTPUT = 2,     // maze complete, rows written so far
+};
+
+/**
+ * @brief Writes a checkpoint to <path>.tmp and renames it over <path> on
+ * commit(), so an interruption never leaves a half written checkpoint.
+ */
+class CheckpointWriter {
+public:
+    static constexpr uint32_t MAGIC = 0x4b434754; // "TGCK"
+    static constexpr uint32_t VERSION = 1;
+
+    CheckpointWriter(const std::string& path, const std::string& key, CheckpointPhase phase)
+        : path_(path), tmp_(path + ".tmp"), out_(tmp_, std::ios::binary | std::ios::trunc) {
+        write(MAGIC);
+        write(VERSION);
+        writeString(key);
+        write(phase);
+    }
+
+    std::ostream& stream() { return out_; }
+
+    template <class T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+        out_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeString(const std::string& value) {
+        write(static_cast<uint64_t>(value.size()));
+        out_.write(value.data(), value.size());
+    }
+
+    /**
+     * @brief Finishes the file and replaces the previous checkpoint.
+     * @return false if writing failed, the previous checkpoint is kept then.
+     */
+    bool commit() {
+        out_.close();
+        if (out_.fail()) return false;
+        return std::rename(tmp_.c_str(), path_.c_str()) == 0;
+    }
+
+private:
+    std::string path_;
+    std::string tmp_;
+    std::ofstream out_;
+};
+
+/**
+ * @brief Reads a checkpoint written by CheckpointWriter.
+ */
+class CheckpointReader {
+public:
+    explicit CheckpointReader(const std::string& path) : in_(path, std::ios::binary) {
+        uint32_t magic = 0, version = 0;
+        read(magic);
+        read(version);
+        valid_ = in_.good() && magic == CheckpointWriter::MAGIC && version == CheckpointWriter::VERSION;
+        if (valid_) valid_ = readString(key_) && read(phase_);
+    }
+
+    /**
+     * @brief True if the file exists and has a supported header.
+     */
+    bool valid() const { return valid_; }
+    const std::string& key() const { return key_; }
+    CheckpointPhase phase() const { return phase_; }
+    std::istream& stream() { return in_; }
+
+    template <class T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read");
+        return static_cast<bool>(in_.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    bool readString(std::string& value) {
+        uint64_t size = 0;
+        if (!read(size) || size > (1u << 20)) return false;
+        value.resize(size);
+        return static_cast<bool>(in_.read(&value[0], size));
+    }
+
+private:
+    std::ifstream in_;
+    bool valid_ = false;
+    std::string key_;
+    CheckpointPhase phase_ = CHECKPOINT_GENERATION;
+};
@@ -0,0 +1,180 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include "maze_algorithms.h"
+#include "maze_grid.h"
+#include "maze_structs.h"
+#include "random.h"
+#include "tileset.h"
+
+/**
+ * @brief Unbounded maze made of independently generated chunks.
+ *
+ * The plane is split into square chunks of chunkSize cells. The interior of
+ * a chunk is carved by a maze algorithm seeded with a hash of the seed and
+ * the chunk coordinates, and every border between two neighbouring chunks
+ * gets one opening at a position hashed from the seed and the border. A
+ * chunk therefore only depends on its own coordinates and can be generated
+ * alone, in any order, with the same result every time.
+ *
+ * Inside a chunk the maze is perfect; the border openings connect all
+ * chunks, so the whole plane is connected with loops only at chunk scale.
+ *
+ * Queries generate the chunk of a cell on demand (O(chunkSize^2)) and keep
+ * the most recently used chunks in an LRU cache. Cell coordinates may be
+ * any 64 bit integers, also negative. Not thread-safe.
+ */
+template <class Rng>
+class ChunkedMaze {
+public:
+    /**
+     * @param tileset The loaded tileset, has to outlive the maze.
+     * @param seed The 64 bit user seed.
+     * @param chunkSize Edge length of a chunk in cells, at least 1.
+     * @param cacheChunks Number of chunks kept in the cache.
+     * @param algorithm The algorithm for the chunk interiors.
+     * @param options The options of the algorithm.
+     */
+    ChunkedMaze(const Tileset& tileset, uint64_t seed, int chunkSize = 64, size_t cacheChunks = 64,
+                MazeAlgorithm<Rng> algorithm = &generateMaze<Rng>, MazeAlgorithmOptions options = {})
+        : tileset_(tileset), lookup_(buildTileLookup(tileset)), seed_(seed),
+          borderSeed_(streamSeed(seed, STREAM_CHUNK_BORDERS)), variantSeed_(streamSeed(seed, STREAM_VARIANTS)),
+          chunkSize_(std::max(chunkSize, 1)),
+          cacheChunks_(std::max<size_t>(cacheChunks, 1)), algorithm_(algorithm), options_(options) {}
+
+    int chunkSize() const { return chunkSize_; }
+    const TileLookup& tileLookup() const { return lookup_; }
+
+    /**
+     * @brief Chunk coordinate of a cell coordinate (rounding towards -inf).
+     */
+    int64_t chunkCoordinate(int64_t v) const {
+        int64_t c = v / chunkSize_;
+        if (v % chunkSize_ < 0) --c;
+        return c;
+    }
+
+    /**
+     * @brief Number of chunks generated so far, i.e. cache misses.
+     */
+    size_t generatedChunks() const { return generated_; }
+
+    /**
+     * @brief Returns the closed walls of a cell, bit d is set if there is a
+     * wall in direction d.
+     */
+    unsigned wallMask(int64_t x, int64_t y) {
+        int64_t cx = chunkCoordinate(x), cy = chunkCoordinate(y);
+        const Chunk& c = chunk(cx, cy);
+        int lx = static_cast<int>(x - cx * chunkSize_);
+        int ly = static_cast<int>(y - cy * chunkSize_);
+        unsigned mask = c.grid.wallMask(lx, ly);
+        const int last = chunkSize_ - 1;
+        if (lx == last && ly == c.openings[0]) mask &= ~1u;
+        if (ly == last && lx == c.openings[1]) mask &= ~2u;
+        if (lx == 0 && ly == c.openings[2]) mask &= ~4u;
+        if (ly == 0 && lx == c.openings[3]) mask &= ~8u;
+        return mask;
+    }
+
+    /**
+     * @brief Returns the tile index of a cell, -1 if no tile matches. Tile
+     * variants are drawn from a hash of the coordinates.
+     */
+    int tileIndex(int64_t x, int64_t y) {
+        const uint64_t cell = hashRandom(static_cast<uint64_t>(x), static_cast<uint64_t>(y));
+        return lookup_.variant(wallMask(x, y), hashRandom(variantSeed_, cell));
+    }
+
+    /**
+     * @brief Appends the polygons of the cell's tile in global coordinates.
+     */
+    void addPolygons(int64_t x, int64_t y, PolygonStore& out) {
+        int tileIdx = tileIndex(x, y);
+        if (tileIdx < 0) return;
+        for (const auto& wall : tileset_.tiles[tileIdx].walls) {
+            for (const auto& [gx, gy] : transform(wall, static_cast<float>(x), static_cast<float>(y), 0.0f)) {
+                out.addCoordinate(MazeCoordinate{gx, gy});
+            }
+            out.closePolygon();
+        }
+    }
+
+private:
+    using ChunkId = std::pair<int64_t, int64_t>;
+
+    struct ChunkIdHash {
+        size_t operator()(const ChunkId& id) const { return static_cast<size_t>(chunkKey(id.first, id.second)); }
+    };
+
+    struct Chunk {
+        explicit Chunk(int chunkSize) : grid(chunkSize, chunkSize) {}
+        ChunkId id;
+        MazeGrid grid;
+        // opening on the right, lower, left and upper border (row/column)
+        int openings[4] = {};
+    };
+
+    /**
+     * @brief Stream index of a chunk: both coordinates packed into 32 bits
+     * each while they fit, a hash of the full 64 bit coordinates beyond. The
+     * cache compares the coordinates themselves, so far chunks never share
+     * an entry.
+     */
+    static uint64_t chunkKey(int64_t cx, int64_t cy) {
+        if (cx == static_cast<int32_t>(cx) && cy == static_cast<int32_t>(cy)) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+        }
+        return hashRandom(hashRandom(~uint64_t(0), static_cast<uint64_t>(cx)), static_cast<uint64_t>(cy));
+    }
+
+    /**
+     * @brief Position of the opening in the right (side 0) or lower (side 1)
+     * border of a chunk.
+     */
+    int borderOpening(int64_t cx, int64_t cy, int side) const {
+        uint64_t h = hashRandom(borderSeed_, chunkKey(cx, cy) * 2 + side);
+        return static_cast<int>(((h >> 32) * static_cast<uint64_t>(chunkSize_)) >> 32);
+    }
+
+    const Chunk& chunk(int64_t cx, int64_t cy) {
+        const ChunkId id{cx, cy};
+        auto it = index_.find(id);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return lru_.front();
+        }
+        if (lru_.size() >= cacheChunks_) {
+            index_.erase(lru_.back().id);
+            lru_.pop_back();
+        }
+        lru_.emplace_front(chunkSize_);
+        Chunk& c = lru_.front();
+        c.id = id;
+        Rng rng(streamSeed(seed_, STREAM_CHUNKS, chunkKey(cx, cy)));
+        algorithm_(c.grid, rng, options_);
+        c.openings[0] = borderOpening(cx, cy, 0);
+        c.openings[1] = borderOpening(cx, cy, 1);
+        c.openings[2] = borderOpening(cx - 1, cy, 0);
+        c.openings[3] = borderOpening(cx, cy - 1, 1);
+        index_.emplace(id, lru_.begin());
+        ++generated_;
+        return c;
+    }
+
+    const Tileset& tileset_;
+    TileLookup lookup_;
+    uint64_t seed_;
+    uint64_t borderSeed_;
+    uint64_t variantSeed_;
+    int chunkSize_;
+    size_t cacheChunks_;
+    MazeAlgorithm<Rng> algorithm_;
+    MazeAlgorithmOptions options_;
+    std::list<Chunk> lru_; // most recently used first
+    std::unordered_map<ChunkId, typename std::list<Chunk>::iterator, ChunkIdHash> index_;
+    size_t generated_ = 0;
+};
@@ -0,0 +1,173 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "maze_grid.h"
+#include "tileset.h"
+
+/**
+ * @brief Wall pattern of a macro tile, bit d of walls[row * width + col] is
+ * set if that cell has a closed wall in direction d.
+ */
+struct MacroTemplate {
+    int macro;
+    int width;
+    int height;
+    std::vector<unsigned> walls;
+};
+
+/**
+ * @brief Macro tile placed with its top left cell at (x, y).
+ */
+struct MacroPlacement {
+    int x;
+    int y;
+    int macro;
+};
+
+/**
+ * @brief The placed macro tiles of a maze and the cells they cover.
+ */
+class MacroLayout {
+public:
+    MacroLayout(int width, int height)
+        : wordsPerRow_((static_cast<size_t>(width) + 63) / 64), covered_(wordsPerRow_ * height, 0) {}
+
+    bool covered(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1u; }
+
+    /**
+     * @brief The placements ordered by row, then column of their top left cell.
+     */
+    const std::vector<MacroPlacement>& placements() const { return placements_; }
+
+private:
+    friend MacroLayout placeMacroTiles(const MazeGrid&, const std::vector<MacroTemplate>&);
+
+    uint64_t* row(int y) { return covered_.data() + wordsPerRow_ * y; }
+    const uint64_t* row(int y) const { return covered_.data() + wordsPerRow_ * y; }
+
+    size_t wordsPerRow_;
+    std::vector<uint64_t> covered_;
+    std::vector<MacroPlacement> placements_;
+};
+
+/**
+ * @brief Compiles the macro tiles into wall templates, largest first.
+ *
+ * Like buildTileLookup only open (O)/closed (X) edges can be matched
+ * against the maze, macro tiles with other labels are skipped.
+ */
+inline std::vector<MacroTemplate> buildMacroTemplates(const Tileset& tileset) {
+    const int open = tileset.edgeId("O");
+    const int closed = tileset.edgeId("X");
+    std::vector<MacroTemplate> templates;
+    for (size_t m = 0; m < tileset.macros.size(); ++m) {
+        const MacroTile& macro = tileset.macros[m];
+        MacroTemplate t{static_cast<int>(m), macro.width, macro.height, {}};
+        bool binary = true;
+        for (const auto& ids : macro.cellEdgeIds) {
+            unsigned walls = 0;
+            for (int d = 0; d < 4; ++d) {
+                if (ids[d] == closed) walls |= 1u << d;
+                else if (ids[d] != open) binary = false;
+            }
+            t.walls.push_back(walls);
+        }
+        if (binary) templates.push_back(t);
+    }
+    std::stable_sort(templates.begin(), templates.end(), [](const MacroTemplate& a, const MacroTemplate& b) {
+        return a.width * a.height > b.width * b.height;
+    });
+    return templates;
+}
+
+/**
+ * @brief Covers the maze with macro tiles wherever their wall pattern
+ * matches, scanning rows top to bottom and trying the largest templates
+ * first. Placed tiles never overlap.
+ *
+ * The closed walls of 64 cells per direction are read as words, so the
+ * cells matching one template cell are a few AND/NOT operations per word,
+ * and the anchors of a whole template are the AND of its cells' match bits
+ * shifted by their offsets, minus the covered cells. Only the anchors left
+ * over are visited one by one.
+ */
+inline MacroLayout placeMacroTiles(const MazeGrid& maze, const std::vector<MacroTemplate>& templates) {
+    const int W = maze.width(), H = maze.height();
+    MacroLayout layout(W, H);
+    if (templates.empty()) return layout;
+    const size_t words = layout.wordsPerRow_;
+    int maxHeight = 1;
+    for (const auto& t : templates) maxHeight = std::max(maxHeight, t.height);
+
+    // closed walls per direction of the rows y .. y + maxHeight - 1, ring buffer by y % maxHeight
+    std::vector<uint64_t> closed(static_cast<size_t>(maxHeight) * 4 * words);
+    auto closedRow = [&](int y, int dir) { return closed.data() + ((y % maxHeight) * 4 + dir) * words; };
+    const uint64_t lastMask = (W & 63) ? (uint64_t(1) << (W & 63)) - 1 : ~uint64_t(0);
+    auto loadRow = [&](int y) {
+        uint64_t carry = 0;
+        for (size_t w = 0; w < words; ++w) {
+            const uint64_t right = maze.openRowWord(y, 0, static_cast<int>(w * 64));
+            closedRow(y, 0)[w] = ~right;
+            closedRow(y, 1)[w] = ~maze.openRowWord(y, 1, static_cast<int>(w * 64));
+            closedRow(y, 2)[w] = ~((right << 1) | carry);
+            closedRow(y, 3)[w] = y > 0 ? ~maze.openRowWord(y - 1, 1, static_cast<int>(w * 64)) : ~uint64_t(0);
+            carry = right >> 63;
+        }
+    };
+    // cells of row y whose walls are exactly the pattern
+    std::vector<uint64_t> match(words + 1, 0);
+    auto matchRow = [&](int y, unsigned walls) {
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t m = w + 1 == words ? lastMask : ~uint64_t(0);
+            for (int d = 0; d < 4; ++d) m &= (walls & (1u << d)) ? closedRow(y, d)[w] : ~closedRow(y, d)[w];
+            match[w] = m;
+        }
+    };
+    // bits of cells x + shift for the anchors x of word w
+    auto shifted = [&](const uint64_t* bits, size_t w, int shift) {
+        if (shift == 0) return bits[w];
+        return (bits[w] >> shift) | (bits[w + 1] << (64 - shift));
+    };
+    auto isFree = [&](const MacroTemplate& t, int x, int y) {
+        for (int j = 0; j < t.height; ++j) {
+            for (int i = 0; i < t.width; ++i) {
+                if (layout.covered(x + i, y + j)) return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<uint64_t> anchors(words);
+    for (int y = 0; y < std::min(H, maxHeight - 1); ++y) loadRow(y);
+    for (int y = 0; y < H; ++y) {
+        if (y + maxHeight - 1 < H) loadRow(y + maxHeight - 1);
+        const size_t rowStart = layout.placements_.size();
+        for (const MacroTemplate& t : templates) {
+            if (y + t.height > H || t.width > W) continue;
+            std::fill(anchors.begin(), anchors.end(), ~uint64_t(0));
+            for (int j = 0; j < t.height; ++j) {
+                for (int i = 0; i < t.width; ++i) {
+                    matchRow(y + j, t.walls[j * t.width + i]);
+                    for (size_t w = 0; w < words; ++w) anchors[w] &= shifted(match.data(), w, i);
+                }
+            }
+            for (size_t w = 0; w < words; ++w) {
+                uint64_t bits = anchors[w] & ~layout.row(y)[w];
+                while (bits) {
+                    const int x = static_cast<int>(w * 64 + __builtin_ctzll(bits));
+                    bits &= bits - 1;
+                    if (!isFree(t, x, y)) continue;
+                    for (int j = 0; j < t.height; ++j) {
+                        for (int i = 0; i < t.width; ++i) layout.row(y + j)[(x + i) >> 6] |= uint64_t(1) << ((x + i) & 63);
+                    }
+                    layout.placements_.push_back(MacroPlacement{x, y, t.macro});
+                }
+            }
+        }
+        // several templates may have placed tiles in this row
+        std::sort(layout.placements_.begin() + rowStart, layout.placements_.end(),
+                  [](const MacroPlacement& a, const MacroPlacement& b) { return a.x < b.x; });
+    }
+    return layout;
+}
@@ -10,365 +10,327 @@
 #include <tuple>
 #include <map>
 #include <array>
+#include <iterator>
 #include <queue>
 #include <algorithm>
+#include <memory>
 #include "maze_structs.h"
-#include "json.hpp"
+#include "maze_grid.h"
+#include "tileset.h"
+#include "random.h"
+#include "parallel.h"
+#include "maze_algorithms.h"
+#include "track_writer.h"
+#include "checkpoint.h"
+#include "chunked_maze.h"
+#include "track_stream.h"
+#include "wfc.h"
+#include "macro_tiles.h"
+#include "shape_mask.h"
 #include <limits>
 #include <stack>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
+#include <chrono>
+#include <csignal>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
 #endif
 
-using json = nlohmann::json;
-unsigned int GRID_SIZE = 0;
-
+// set by SIGINT/SIGTERM, a checkpointed run saves its state and stops
+static volatile std::sig_atomic_t stopRequested = 0;
 
 /**
- * @brief representation of a tile 
- * @var edges: open (O)/closed (X) connections on the tile edges 
- * 
+ * @brief Command line split into positional arguments and --name [value] options.
  */
-struct Tile {
-    std::string name;
-    std::vector<std::vector<std::pair<float, float>>> walls;
-    std::vector<std::array<std::string, 4>> edges;
-    int index = -1;
-    std::vector<std::vector<int>> validNeighbors;
+struct CommandLine {
+    std::vector<std::string> positional;
+    std::map<std::string, std::string> options;
+
+    bool has(const std::string& name) const { return options.count(name) > 0; }
+    std::string get(const std::string& name, const std::string& fallback) const {
+        auto it = options.find(name);
+        return it != options.end() ? it->second : fallback;
+    }
 };
 
 /**
- * @brief Checks if two edge match with closed or open connections
- * @return true if edges match (open-to-open or wall-to-wall), false otherwise
+ * @brief Parses the command line, every --name takes the next argument as
+ * value unless it is listed in flags.
  */
-bool edgesMatch(const std::string& a, const std::string& b) {
-    // Only allow open-to-open and wall-to-wall
-    return (a == "O" && b == "O") || (a == "X" && b == "X");
+CommandLine parseCommandLine(int argc, char* argv[], const std::set<std::string>& flags) {
+    CommandLine cmd;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            cmd.positional.push_back(arg);
+            continue;
+        }
+        std::string name = arg.substr(2);
+        if (flags.count(name) || i + 1 >= argc) cmd.options[name] = "";
+        else cmd.options[name] = argv[++i];
+    }
+    return cmd;
 }
 
 /**
- * @brief Rotates the walls of a tile so the
- * wall positions are updated according to the rotation.
- *
- * @param walls The original wall positions.
- * @param rot The rotation angle in 90-degree increments (0-3).
+ * @brief 64 bit FNV-1a hash of a file's content, 0 if it cannot be read.
  */
-std::vector<std::vector<std::pair<float, float>>> rotateWalls(
-    const std::vector<std::vector<std::pair<float, float>>>& walls, int rot) {
-    std::vector<std::vector<std::pair<float, float>>> result = walls;
-    float angle = rot * (M_PI / 2.0f);
-    float cos_a = std::cos(angle);
-    float sin_a = std::sin(angle);
-    for (auto& wall : result) {
-        for (auto& p : wall) {
-            float x = p.first - 0.5f;
-            float y = p.second - 0.5f;
-            float x_new = cos_a * x - sin_a * y;
-            float y_new = sin_a * x + cos_a * y;
-            p.first = x_new + 0.5f;
-            p.second = y_new + 0.5f;
-        }
+uint64_t fileHash(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return 0;
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (std::istreambuf_iterator<char> it(in), end; it != end; ++it) {
+        h ^= static_cast<unsigned char>(*it);
+        h *= 0x100000001b3ull;
     }
-    return result;
+    return h;
 }
 
 /**
- * @brief Loads a tileset from a JSON file and generates all rotations.
- *
- * @param filename The path to the JSON file.
- * @return std::vector<Tile> A vector of all tiles with their rotations.
+ * @brief Prints the wall clock time and the page faults of each stage when
+ * enabled, plus the throughput for stages that process cells.
  */
-std::vector<Tile> loadTilesetWithEdges(const std::string& filename) {
-    std::ifstream file(filename);
-    json j;
-    file >> j;
-    std::vector<Tile> baseTiles;
-    std::vector<Tile> allTiles;
-    int idx = 0;
-    for (const auto& t : j) {
-        Tile tile;
-        tile.name = t["name"];
-        for (const auto& wall : t["walls"]) {
-            std::vector<std::pair<float, float>> wall_coords;
-            const float padding = 0.0025f; // 5% padding on each side
-            for (const auto& coord : wall) {
-                // Move each coordinate towards the center (0.5, 0.5)
-                float x = coord[0];
-                float y = coord[1];
-                float x_padded = 0.5f + (x - 0.5f) * (1.0f - 2.0f * padding);
-                float y_padded = 0.5f + (y - 0.5f) * (1.0f - 2.0f * padding);
-                wall_coords.emplace_back(x_padded, y_padded);
-            }
-            tile.walls.push_back(wall_coords);
-        }
-        if (t.contains("edges")) {
-            for (const auto& e : t["edges"]) {
-                std::array<std::string, 4> arr;
-                for (int i = 0; i < 4; ++i) arr[i] = e[i];
-                tile.edges.push_back(arr);
-            }
-        } else {
-            std::cout << "Missing edge definitions for tile: " << tile.name << std::endl;
-            tile.edges.push_back({"X", "X", "X", "X"});
-        }
-        tile.index = idx++;
-        baseTiles.push_back(tile);
-    }
-    // generate all rotations and filter duplicates
-    for (const auto& tile : baseTiles) {
-        for (int i = 0; i < tile.edges.size(); ++i) {
-            Tile t = tile;
-            t.edges.clear();
-            t.edges.push_back(tile.edges[i]);
-            int extra_rot = 0;
-            if (tile.name.find("curve") != std::string::npos) extra_rot = 1;
-            if (tile.name.find("endcap") != std::string::npos) extra_rot = 2;
-            t.walls = rotateWalls(tile.walls, (i + extra_rot) % 4);
-            t.name = tile.name + "_rot" + std::to_string(i*90);
-            t.index = allTiles.size();
-            allTiles.push_back(t);
-        }
+class StageTimer {
+public:
+    explicit StageTimer(bool enabled) : enabled_(enabled), start_(std::chrono::steady_clock::now()) {
+        pageFaults(minorFaults_, majorFaults_);
     }
-    // calculate adjacency list for each tile
-    for (int t = 0; t < allTiles.size(); ++t) {
-        allTiles[t].validNeighbors.resize(4);
-        for (int dir = 0; dir < 4; ++dir) {
-            for (int n = 0; n < allTiles.size(); ++n) {
-                if (edgesMatch(allTiles[t].edges[0][dir], allTiles[n].edges[0][(dir+2)%4])) {
-                    allTiles[t].validNeighbors[dir].push_back(n);
-                }
-            }
-        }
-    }
-    return allTiles;
-}
-
-struct Cell {
-    bool collapsed = false;
-    std::vector<int> options;
-};
 
-// bounds for tiles so they dont overlap
-struct Bounds {
-    float minX = std::numeric_limits<float>::max();
-    float minY = std::numeric_limits<float>::max();
-    float maxX = std::numeric_limits<float>::lowest();
-    float maxY = std::numeric_limits<float>::lowest();
-    void update(float x, float y) {
-        minX = std::min(minX, x);
-        minY = std::min(minY, y);
-        maxX = std::max(maxX, x);
-        maxY = std::max(maxY, y);
+    /**
+     * @brief Ends the current stage and starts the next one.
+     *
+     * @param name The name of the finished stage.
+     * @param cells Number of cells the stage processed, 0 to omit the throughput.
+     */
+    void stage(const char* name, size_t cells = 0) {
+        auto now = std::chrono::steady_clock::now();
+        long minor, major;
+        pageFaults(minor, major);
+        if (enabled_) {
+            double ms = std::chrono::duration<double, std::milli>(now - start_).count();
+            std::cout << "[timing] " << std::left << std::setw(20) << name << std::right << std::fixed
+                      << std::setprecision(2) << ms << " ms";
+            if (cells > 0 && ms > 0) std::cout << ", " << cells / ms / 1000.0 << " Mcells/s";
+            std::cout << ", page faults " << minor - minorFaults_ << " minor / " << major - majorFaults_ << " major"
+                      << std::defaultfloat << std::endl;
+        }
+        pageFaults(minorFaults_, majorFaults_);
+        start_ = std::chrono::steady_clock::now();
     }
-    float width() const { return maxX - minX; }
-    float height() const { return maxY - minY; }
-};
-
-Bounds calculateBounds(const std::list<Mazepolygon>& polygons) {
-    Bounds bounds;
-
-    float padding = 0.01f;
-    bounds.minX += padding;
-    bounds.minY += padding;
-    bounds.maxX -= padding;
-    bounds.maxY -= padding;
 
-    for (const auto& poly : polygons) {
-        for (const auto& coord : poly.coordinates) {
-            bounds.update(coord.x, coord.y);
+private:
+    static void pageFaults(long& minor, long& major) {
+        minor = major = 0;
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            minor = usage.ru_minflt;
+            major = usage.ru_majflt;
         }
+#endif
     }
-    return bounds;
-}
 
-// helper
-using Edge = std::pair<std::pair<int,int>, std::pair<int,int>>;
+    bool enabled_;
+    std::chrono::steady_clock::time_point start_;
+    long minorFaults_;
+    long majorFaults_;
+};
 
 /**
- * @brief Exports the maze polygons and solution edges to an SVG file.
+ * @brief Decides which cells become fourway crossings.
  *
- * @param polygons The maze polygons to export.
- * @param filename The name of the output SVG file.
- * @param solutionEdges The solution edges to include in the SVG.
- * @param DIM The dimension of the maze.
+ * Every interior cell is a crossing with the given probability. The
+ * decision for a cell is drawn from a counter-based stream indexed by the
+ * cell, so it does not depend on the processing order, the number of
+ * threads or on how much of the maze is in memory. With a shape mask only
+ * its interior cells can become crossings.
  */
-void exportSVG(const std::list<Mazepolygon>& polygons, const std::string& filename, const std::vector<Edge>& solutionEdges, int DIM) {
-    std::ofstream svg(filename);
-    Bounds bounds = calculateBounds(polygons);
-    float scale = std::min(1000.0f / bounds.width(), 1000.0f / bounds.height());
-    char header[512];
-    snprintf(header, sizeof(header), "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"%f %f %f %f\">\n    <rect width=\"100%%\" height=\"100%%\" fill=\"#f8f8f8\"/>\n", 1000, 1000, bounds.minX, bounds.minY, bounds.width(), bounds.height());
-    svg << header;
-    // draw grid
-    svg << "    <g stroke=\"#bbb\" stroke-width=\"0.02\">\n";
-    for (int i = 0; i <= GRID_SIZE; ++i) {
-        float x = i * 1.0f;
-        svg << "        <line x1=\"" << x << "\" y1=\"0\" x2=\"" << x << "\" y2=\"" << GRID_SIZE << "\" />\n";
-        svg << "        <line x1=\"0\" y1=\"" << x << "\" x2=\"" << GRID_SIZE << "\" y2=\"" << x << "\" />\n";
-    }
-    svg << "    </g>\n";
-    svg << "    <circle cx=\"0\" cy=\"0\" r=\"0.2\" fill=\"red\"/>\n";
-    // solutiongraph lines
-    svg << "    <g stroke=\"#d22\" stroke-width=\"0.05\">\n";
-    for (const auto& edge : solutionEdges) {
-        float x1 = edge.first.first + 0.5f;
-        float y1 = edge.first.second + 0.5f;
-        float x2 = edge.second.first + 0.5f;
-        float y2 = edge.second.second + 0.5f;
-        svg << "        <line x1=\"" << x1 << "\" y1=\"" << y1 << "\" x2=\"" << x2 << "\" y2=\"" << y2 << "\" />\n";
+struct CrossingSampler {
+    CrossingSampler(float probability, uint64_t seed, int width, int height, const ShapeMask* mask = nullptr)
+        : seed(seed), threshold(static_cast<uint64_t>(probability * 16777216.0)), width(width), height(height), mask(mask) {}
+
+    bool isCrossing(int x, int y) const {
+        if (x < 1 || x >= width-1 || y < 1 || y >= height-1) return false;
+        if (mask && !((mask->interiorRow(y)[x >> 6] >> (x & 63)) & 1u)) return false;
+        return (hashRandom(seed, static_cast<uint64_t>(y) * width + x) >> 40) < threshold;
     }
-    svg << "    </g>\n";
-    for (const auto& poly : polygons) {
-        if (poly.coordinates.empty()) continue;
-        svg << "    <path d=\"M ";
-        bool first = true;
-        for (const auto& coord : poly.coordinates) {
-            if (!first) svg << " L ";
-            svg << coord.x << "," << coord.y;
-            first = false;
+
+    /**
+     * @brief Crossing bits of a whole row, bit x % 64 of word x / 64 is
+     * isCrossing(x, y). The draws are made in blocks of 64 cells and
+     * compared without branches.
+     */
+    void rowBits(int y, uint64_t* words) const {
+        const int count = (width + 63) / 64;
+        std::fill(words, words + count, 0);
+        if (y < 1 || y >= height-1) return;
+        const uint64_t base = static_cast<uint64_t>(y) * width;
+        for (int w = 0; w < count; ++w) {
+            const int x0 = w * 64;
+            const int n = std::min(64, width - x0);
+            uint64_t word = 0;
+            for (int i = 0; i < n; ++i) {
+                word |= static_cast<uint64_t>((hashRandom(seed, base + x0 + i) >> 40) < threshold) << i;
+            }
+            words[w] = word;
         }
-        svg << " Z\" fill=\"#333333\" stroke=\"none\"/>\n";
+        // the border cells are never crossings
+        words[0] &= ~uint64_t(1);
+        words[(width-1) / 64] &= ~(uint64_t(1) << ((width-1) & 63));
+        if (!mask) return;
+        const uint64_t* interior = mask->interiorRow(y);
+        for (int w = 0; w < count; ++w) words[w] &= interior[w];
     }
-    svg << "</svg>";
-    svg.close();
-}
+
+    uint64_t seed;
+    uint64_t threshold;
+    int width;
+    int height;
+    const ShapeMask* mask;
+};
 
 /**
- * @brief Transforms a set of 2D coordinates by applying translation and rotation.
+ * @brief Adds the crossings row by row.
+ *
+ * Only the right/down bits of a row are written: a cell opens its
+ * right/down wall if it or its right/lower neighbour is a crossing. The
+ * up/left walls of a crossing are opened by the rows and cells before it,
+ * so after all rows are processed every crossing has four open walls.
  *
- * @param coords The coordinates to transform.
- * @param dx The translation in the x direction.
- * @param dy The translation in the y direction.
- * @param angle_rad The rotation angle in radians.
- * @return The transformed coordinates.
+ * Both conditions are evaluated for 64 cells at once on the crossing bits,
+ * the right bits are c | c >> 1 (plus the first bit of the next word), the
+ * down bits c | c_below. The bits of the row below are kept for the next
+ * row, so every row is sampled once when the rows are applied in order.
  */
-std::vector<std::pair<float, float>> transform(const std::vector<std::pair<float, float>>& coords, float dx, float dy, float angle_rad) {
-    std::vector<std::pair<float, float>> result;
-    float cos_a = std::cos(angle_rad);
-    float sin_a = std::sin(angle_rad);
-    for (const auto& [x, y] : coords) {
-        float x_new = cos_a * x - sin_a * y + dx;
-        float y_new = sin_a * x + cos_a * y + dy;
-        result.emplace_back(x_new, y_new);
+class CrossingPass {
+public:
+    explicit CrossingPass(const CrossingSampler& crossings)
+        : crossings_(crossings), words_((crossings.width + 63) / 64), current_(words_), below_(words_) {}
+
+    /**
+     * @param maze The maze to modify.
+     * @param row The row inside maze.
+     * @param y The row inside the complete maze, differs from row when maze
+     *          only holds a window of rows.
+     */
+    void apply(MazeGrid& maze, int row, int y) {
+        if (y == nextY_) std::swap(current_, below_);
+        else crossings_.rowBits(y, current_.data());
+        crossings_.rowBits(y + 1, below_.data());
+        nextY_ = y + 1;
+        for (size_t w = 0; w < words_; ++w) {
+            uint64_t c = current_[w];
+            uint64_t carry = w + 1 < words_ ? current_[w + 1] << 63 : 0;
+            maze.openRowBits(row, 0, static_cast<int>(w * 64), c | (c >> 1) | carry);
+            maze.openRowBits(row, 1, static_cast<int>(w * 64), c | below_[w]);
+        }
     }
-    return result;
-}
 
-struct MazeCell {
-    bool visited = false;
-    bool walls[4] = {true, true, true, true}; // 0: rechts, 1: unten, 2: links, 3: oben
+private:
+    const CrossingSampler& crossings_;
+    size_t words_;
+    std::vector<uint64_t> current_;
+    std::vector<uint64_t> below_;
+    int nextY_ = -1;
 };
 
 /**
- * @brief Generates a random maze using depth-first search.
+ * @brief Adds crossings to the maze.
+ *
+ * The rows are split between the threads, every thread only writes the
+ * bits of its own rows (whole row groups for layouts that pack several rows
+ * into a word). The solution graph is derived from the open walls
+ * afterwards, so opening a wall is all that is needed to add the edge to it.
  *
  * @param maze The maze to modify.
- * @param DIM The dimension of the maze.
- * @param rng The random number generator.
- * @param solutionEdges The solution edges to update.
+ * @param crossings The crossing decisions.
+ * @param threads The number of threads.
  */
-void generateMaze(std::vector<std::vector<MazeCell>>& maze, int DIM, std::mt19937& rng, std::vector<Edge>& solutionEdges) {
-    std::stack<std::pair<int, int>> stack;
-    stack.push({0, 0});
-    maze[0][0].visited = true;
-    std::uniform_int_distribution<int> dirDist(0, 3);
-    const int dx[4] = {1, 0, -1, 0};
-    const int dy[4] = {0, 1, 0, -1};
-    while (!stack.empty()) {
-        int x = stack.top().first, y = stack.top().second;
-        std::vector<int> dirs = {0, 1, 2, 3};
-        std::shuffle(dirs.begin(), dirs.end(), rng);
-        bool moved = false;
-        for (int dir : dirs) {
-            int nx = x + dx[dir], ny = y + dy[dir];
-            if (nx >= 0 && nx < DIM && ny >= 0 && ny < DIM && !maze[ny][nx].visited) {
-                maze[y][x].walls[dir] = false;
-                maze[ny][nx].walls[(dir+2)%4] = false;
-                maze[ny][nx].visited = true;
-                stack.push({nx, ny});
-                // add edge to solutiongraph
-                solutionEdges.push_back({{x, y}, {nx, ny}});
-                moved = true;
-                break;
-            }
-        }
-        if (!moved) stack.pop();
-    }
+void addCrossings(MazeGrid& maze, const CrossingSampler& crossings, unsigned threads) {
+    // split at row groups that do not share words
+    const int align = maze.rowAlignment();
+    const int groups = (maze.height() + align - 1) / align;
+    parallelFor(groups, threads, [&](size_t begin, size_t end) {
+        int yEnd = std::min(maze.height(), static_cast<int>(end) * align);
+        CrossingPass pass(crossings);
+        for (int y = static_cast<int>(begin) * align; y < yEnd; ++y) pass.apply(maze, y, y);
+    });
 }
 
 /**
- * @brief Adds crossings to the maze.
+ * @brief Writes one row of the track.
  *
- * @param maze The maze to modify.
- * @param DIM The dimension of the maze.
- * @param crossingProbability The probability of adding a crossing.
- * @param rng The random number generator.
- * @param solutionEdges The solution edges to update.
+ * The polygons of the row's tiles go to the loader and the SVG, every cell
+ * becomes a solution graph node at its center with the cells behind its
+ * open walls as neighbours (64 bit row-major node indices), and the right/down
+ * passages are drawn as solution edges.
+ *
+ * @param tiles The list of available tiles.
+ * @param rowWalls The closed walls of every cell of the row (bit d = direction d).
+ * @param rowTiles The tile index of every cell of the row, -1 for none.
+ * @param y The row index.
+ * @param width The maze width.
+ * @param loader The writer for the generated code.
+ * @param svg The writer for the SVG visualisation.
  */
-void addCrossings(std::vector<std::vector<MazeCell>>& maze, int DIM, float crossingProbability, std::mt19937& rng, std::vector<Edge>& solutionEdges) {
-    std::uniform_real_distribution<float> probDist(0.0f, 1.0f);
-    for (int y = 1; y < DIM-1; ++y) {
-        for (int x = 1; x < DIM-1; ++x) {
-            int openCount = 0;
-            for (int d = 0; d < 4; ++d) {
-                if (!maze[y][x].walls[d]) openCount++;
-            }
-            if (openCount < 4 && probDist(rng) < crossingProbability) {
-                // Open all walls to make a fourway crossing
-                for (int d = 0; d < 4; ++d) {
-                    if (maze[y][x].walls[d]) {
-                        maze[y][x].walls[d] = false;
-                        int nx = x + (d == 0 ? 1 : d == 2 ? -1 : 0);
-                        int ny = y + (d == 1 ? 1 : d == 3 ? -1 : 0);
-                        if (nx >= 0 && nx < DIM && ny >= 0 && ny < DIM) {
-                            maze[ny][nx].walls[(d+2)%4] = false;
-                            // Add to solutionEdges if not already present
-                            Edge e1 = {{x, y}, {nx, ny}};
-                            Edge e2 = {{nx, ny}, {x, y}};
-                            if (std::find(solutionEdges.begin(), solutionEdges.end(), e1) == solutionEdges.end() &&
-                                std::find(solutionEdges.begin(), solutionEdges.end(), e2) == solutionEdges.end()) {
-                                solutionEdges.push_back(e1);
-                            }
-                        }
-                    }
-                }
+void writeTrackRow(const std::vector<Tile>& tiles, const unsigned* rowWalls, const int* rowTiles, int y, int width,
+                   LoaderWriter& loader, SvgWriter& svg) {
+    std::vector<MazeCoordinate> coords;
+    for (int x = 0; x < width; ++x) {
+        if (rowTiles[x] < 0) continue;
+        const Tile& tile = tiles[rowTiles[x]];
+        float gx = x * 1.0f;
+        float gy = y * 1.0f;
+        float angle = 0.0f;
+        for (const auto& wall : tile.walls) {
+            auto global_coords = transform(wall, gx, gy, angle);
+            coords.clear();
+            for (const auto& [gx, gy] : global_coords) {
+                coords.push_back(MazeCoordinate{gx, gy});
             }
+            loader.addPolygon(coords.data(), coords.size());
+            svg.addPolygon(coords.data(), coords.size());
         }
     }
+    for (int x = 0; x < width; ++x) {
+        uint64_t neighbors[4];
+        size_t count = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (rowWalls[x] & (1u << d)) continue;
+            neighbors[count++] = static_cast<uint64_t>(y + DIR_DY[d]) * width + (x + DIR_DX[d]);
+            // right and down passage, each edge is drawn once
+            if (d < 2) svg.addEdge(x + 0.5f, y + 0.5f, x + 0.5f + DIR_DX[d], y + 0.5f + DIR_DY[d]);
+        }
+        loader.addNode(MazeCoordinate{x + 0.5f, y + 0.5f}, neighbors, count);
+    }
 }
 
 /**
- * @brief Finds a matching tile for a given set of wall configurations.
+ * @brief Writes the polygons of the macro tiles whose top left cell lies in
+ * row y. Placements of earlier rows that were not written (resumed output)
+ * are skipped.
  *
- * @param tiles The list of available tiles.
- * @param walls The wall configurations to match.
- * @param x The x-coordinate of the cell (for debugging purposes).
- * @param y The y-coordinate of the cell (for debugging purposes).
- * @return int The index of the matching tile, or -1 if none found.
+ * @param macros The macro tiles of the tileset.
+ * @param placements The placed macro tiles, ordered by row.
+ * @param next Index of the first placement not written yet, moved past row y.
+ * @param y The row index.
+ * @param loader The writer for the generated code.
+ * @param svg The writer for the SVG visualisation.
  */
-int findMatchingTile(const std::vector<Tile>& tiles, const bool walls[4], int x = -1, int y = -1) {
-    for (int t = 0; t < tiles.size(); ++t) {
-        for (int rot = 0; rot < 4; ++rot) {
-            const auto& edge = tiles[t].edges[0];
-            bool match = true;
-            for (int d = 0; d < 4; ++d) {
-                if (walls[d]) {
-                    if (edge[d] != "X") { match = false; break; }
-                } else {
-                    if (edge[d] != "O") { match = false; break; }
-                }
+void writeMacroRow(const std::vector<MacroTile>& macros, const std::vector<MacroPlacement>& placements, size_t& next,
+                   int y, LoaderWriter& loader, SvgWriter& svg) {
+    std::vector<MazeCoordinate> coords;
+    for (; next < placements.size() && placements[next].y <= y; ++next) {
+        const MacroPlacement& placement = placements[next];
+        if (placement.y < y) continue;
+        for (const auto& wall : macros[placement.macro].walls) {
+            coords.clear();
+            for (const auto& [gx, gy] : transform(wall, placement.x * 1.0f, y * 1.0f, 0.0f)) {
+                coords.push_back(MazeCoordinate{gx, gy});
             }
-            if (match) return t;
+            loader.addPolygon(coords.data(), coords.size());
+            svg.addPolygon(coords.data(), coords.size());
         }
     }
-    // missing combinations
-    if (x >= 0 && y >= 0) {
-        std::cout << "Kein passendes Tile für Zelle (" << x << "," << y << ") mit Wänden: ";
-        for (int d = 0; d < 4; ++d) std::cout << (walls[d] ? "1" : "0");
-        std::cout << std::endl;
-    }
-    return -1;
 }
 
 /**
@@ -379,133 +341,397 @@ int findMatchingTile(const std::vector<Tile>& tiles, const bool walls[4], int x
  *         [2] - Output file for the generated maze
  *         [3] - Grid size (optional, default 10)
  *         [4] - Crossing probability (optional, default 0.1)
- *         [5] - Seed (optional, default random), allows reproducible results
+ *         [5] - Seed (optional, default random), full 64 bit integer, allows reproducible results
+ *         --algorithm <name> - maze algorithm: dfs (default), parallel-dfs, kruskal, wilson, prim, growing-tree, hunt-and-kill or eller,
+ *                              or wfc: wave function collapse over the tileset's edge labels (no crossings),
+ *                              parallel-wfc: wfc in regions on all threads, seams solved again where they do not fit
+ *         --width <n>, --height <n> - grid size if it is not square (default: grid size, or the mask image size)
+ *         --mask <file.pgm> - shape mask, only the light pixels become track cells, the others get the block
+ *                             tile (scaled to the grid, dfs only)
+ *         --region-size <n> - region edge length of parallel-dfs and parallel-wfc (default 256)
+ *         --growing-tree-newest <p> - probability that growing-tree continues from the newest cell (default 0.5)
+ *         --rng <name> - random engine: mt19937, xoshiro256 (default), pcg64 or splitmix
+ *         --layout <name> - cell order in memory: row-major (default) or morton (8x8 Z-order tiles),
+ *                           the maze does not depend on it; --stream always uses row-major
+ *         --storage <path> - keep the maze bits and the DFS stack in memory-mapped files <path>.*
+ *                            (out-of-core generation, implies --layout morton)
+ *         --checkpoint <file> - save the state of a dfs run to file every --checkpoint-interval seconds
+ *                               (default 300) and on SIGINT/SIGTERM
+ *         --resume - continue from the checkpoint, the output is identical to an uninterrupted run
+ *         --query <x>,<y> - print walls, tile and polygons of one cell of the unbounded chunked maze
+ *                           for the seed, without generating a grid (any integer coordinates)
+ *         --chunk-size <n> - chunk edge length of the chunked maze (default 64)
+ *         --follow <file|-> - read robot positions "x y" (in cells) and write add/remove deltas of the
+ *                             chunked maze around the robot to the output file ("-" = stdout)
+ *         --window <n> - chunks kept around the robot in every direction (default 1)
+ *         --ahead <n> - chunks generated ahead in the direction of motion (default 1)
+ *         --threads <n> - worker threads, the output does not depend on it
+ *         --stream - generate with Eller's algorithm row by row and write each row right away,
+ *                    memory only grows with the grid width (no --hash)
+ *         --no-macros - only use single cell tiles, no macro tiles spanning several cells
+ *         --hash - print a hash of the generated maze
+ *         --timings - print the wall clock time, throughput and page faults of every stage
  * @return Output file with generated maze represented as polygons.
  */
 int main(int argc, char* argv[]) {
-    if (argc < 3 ) {
-        std::cout << "Usage: " << argv[0] << " <tileset.json> <output.cpp> [grid_size] [crossing probability] [seed]\n";
+    CommandLine cmd = parseCommandLine(argc, argv, {"timings", "hash", "stream", "resume", "no-macros"});
+    const auto& args = cmd.positional;
+    if (args.size() < 2) {
+        std::cout << "Usage: " << argv[0] << " <tileset.json> <output.cpp> [grid_size] [crossing probability] [seed]"
+                  << " [--width n] [--height n] [--mask file.pgm] [--algorithm " << mazeAlgorithmNames() << "|wfc|parallel-wfc] [--region-size n] [--growing-tree-newest p]"
+                  << " [--rng mt19937|xoshiro256|pcg64|splitmix] [--layout row-major|morton] [--storage path] [--checkpoint file [--checkpoint-interval s] [--resume]] [--query x,y | --follow file [--window n] [--ahead n]] [--chunk-size n] [--threads n] [--stream] [--no-macros] [--hash] [--timings]\n";
         return 1;
     }
-    std::string tileset_file = argv[1];
-    std::string output_file = argv[2];
-    unsigned int grid_size = argc > 3 ? std::stoul(argv[3]) : 10;
-    float crossing_probability = argc > 4 ? std::stof(argv[4]) : 0.1f;
-    float seed = argc > 5 ? std::stof(argv[5]) : std::random_device{}();
-    std::mt19937 rng(seed);
+    std::string tileset_file = args[0];
+    std::string output_file = args[1];
+    unsigned int grid_size = args.size() > 2 ? std::stoul(args[2]) : 10;
+    float crossing_probability = args.size() > 3 ? std::stof(args[3]) : 0.1f;
+    uint64_t seed = args.size() > 4 ? std::stoull(args[4], nullptr, 0)
+                                    : (uint64_t(std::random_device{}()) << 32) | std::random_device{}();
+    std::string rng_engine = cmd.get("rng", "xoshiro256");
+    std::string algorithm = cmd.get("algorithm", "dfs");
+    MazeAlgorithmOptions algorithm_options;
+    algorithm_options.growingTreeNewest = std::stof(cmd.get("growing-tree-newest", "0.5"));
+    unsigned threads = std::stoul(cmd.get("threads", std::to_string(std::max(1u, std::thread::hardware_concurrency()))));
+    algorithm_options.threads = threads;
+    algorithm_options.regionSize = std::stoi(cmd.get("region-size", "256"));
+    StageTimer timer(cmd.has("timings"));
 
-    auto tiles = loadTilesetWithEdges(tileset_file);
-    int DIM = grid_size;
+    // names are checked before any output file is opened
+    const bool tile_algorithm = algorithm == "wfc" || algorithm == "parallel-wfc";
+    if (!tile_algorithm && !findMazeAlgorithm<Xoshiro256>(algorithm)) {
+        std::cerr << "Unknown maze algorithm: " << algorithm << std::endl;
+        return 1;
+    }
+    if (!withRngEngine(rng_engine, 0, [](auto&) {})) {
+        std::cerr << "Unknown random engine: " << rng_engine << std::endl;
+        return 1;
+    }
+    if (tile_algorithm && (cmd.has("query") || cmd.has("follow"))) {
+        std::cerr << "--query and --follow need a maze algorithm, not " << algorithm << std::endl;
+        return 1;
+    }
+    const int chunk_size = std::stoi(cmd.get("chunk-size", "64"));
+    if (chunk_size < 1) {
+        std::cerr << "--chunk-size needs at least 1 cell" << std::endl;
+        return 1;
+    }
 
-    // generate maze
-    std::vector<std::vector<MazeCell>> maze(DIM, std::vector<MazeCell>(DIM));
-    std::vector<Edge> solutionEdges;
-    generateMaze(maze, DIM, rng, solutionEdges);
-    addCrossings(maze, DIM, crossing_probability, rng, solutionEdges);
+    Tileset tileset = loadTilesetWithEdges(tileset_file);
+    if (tileset.tiles.empty()) return 1;
+    const auto& tiles = tileset.tiles;
 
-    // grid für Tiles
-    std::vector<std::vector<Cell>> grid(DIM, std::vector<Cell>(DIM));
-    for (int y = 0; y < DIM; ++y) {
-        for (int x = 0; x < DIM; ++x) {
-            int tileIdx = findMatchingTile(tiles, maze[y][x].walls, x, y);
-            if (tileIdx >= 0) {
-                grid[y][x].collapsed = true;
-                grid[y][x].options = {tileIdx};
-            } else {
-                // Blocktile
-                int block_index = -1;
-                for (int i = 0; i < tiles.size(); ++i) {
-                    if (tiles[i].name.find("block") != std::string::npos) {
-                        block_index = i;
-                        break;
-                    }
-                }
-                grid[y][x].collapsed = true;
-                grid[y][x].options = {block_index};
-            }
+    // single cell of the unbounded chunked maze, nothing else is generated
+    if (cmd.has("query")) {
+        std::string query = cmd.get("query", "");
+        size_t comma = query.find(',');
+        if (comma == std::string::npos) {
+            std::cerr << "--query expects <x>,<y>" << std::endl;
+            return 1;
         }
+        int64_t qx = std::stoll(query.substr(0, comma)), qy = std::stoll(query.substr(comma + 1));
+        withRngEngine(rng_engine, seed, [&](auto& rng) {
+            using Rng = std::decay_t<decltype(rng)>;
+            auto generate = findMazeAlgorithm<Rng>(algorithm);
+            ChunkedMaze<Rng> chunked(tileset, seed, chunk_size, 64, generate, algorithm_options);
+            unsigned walls = chunked.wallMask(qx, qy);
+            int tileIdx = chunked.tileIndex(qx, qy);
+            PolygonStore cell;
+            chunked.addPolygons(qx, qy, cell);
+            std::cout << "Zelle (" << qx << ", " << qy << "): Wände ";
+            for (int d = 0; d < 4; ++d) std::cout << ((walls & (1u << d)) ? "1" : "0");
+            std::cout << ", Tile " << (tileIdx >= 0 ? tiles[tileIdx].name : "-") << ", " << cell.size() << " Polygone\n";
+            for (const Mazepolygon poly : cell) {
+                std::cout << "   ";
+                for (const auto& c : poly.coordinates) std::cout << " {" << c.x << ", " << c.y << "}";
+                std::cout << "\n";
+            }
+        });
+        return 0;
     }
 
-    // generate polygons
-    std::list<Mazepolygon> polygons;
-    for (int y = 0; y < DIM; ++y) {
-        for (int x = 0; x < DIM; ++x) {
-            const auto& cell = grid[y][x];
-            if (!cell.collapsed) continue;
-            const Tile& tile = tiles[cell.options[0]];
-            float gx = x * 1.0f;
-            float gy = y * 1.0f;
-            float angle = 0.0f;
-            for (const auto& wall : tile.walls) {
-
-                auto global_coords = transform(wall, gx, gy, angle);
-                Mazepolygon poly;
-                for (const auto& [gx, gy] : global_coords) {
-                    poly.coordinates.push_back(MazeCoordinate{gx, gy});
-                }
-                polygons.push_back(poly);
-            }
+    // endless track around a moving robot, positions in, geometry deltas out
+    if (cmd.has("follow")) {
+        std::string positions_file = cmd.get("follow", "-");
+        std::ifstream positions_in;
+        if (positions_file != "-") positions_in.open(positions_file);
+        std::istream& positions = positions_file == "-" ? std::cin : positions_in;
+        std::ofstream deltas_out;
+        if (output_file != "-") deltas_out.open(output_file);
+        std::ostream& deltas = output_file == "-" ? std::cout : deltas_out;
+        if (!positions || !deltas) {
+            std::cerr << "Cannot open " << (!positions ? positions_file : output_file) << std::endl;
+            return 1;
         }
+        int radius = std::stoi(cmd.get("window", "1"));
+        int ahead = std::stoi(cmd.get("ahead", "1"));
+        withRngEngine(rng_engine, seed, [&](auto& rng) {
+            using Rng = std::decay_t<decltype(rng)>;
+            auto generate = findMazeAlgorithm<Rng>(algorithm);
+            // the cache holds both squares of the window
+            size_t window_chunks = 2 * static_cast<size_t>(2 * radius + 1) * (2 * radius + 1);
+            ChunkedMaze<Rng> chunked(tileset, seed, chunk_size, window_chunks, generate, algorithm_options);
+            TrackStreamer<Rng> streamer(chunked, deltas, radius, ahead);
+            size_t updates = 0;
+            double x, y;
+            while (positions >> x >> y) {
+                streamer.moveTo(x, y);
+                ++updates;
+            }
+            std::cerr << "Positionen: " << updates << ", aktive Chunks: " << streamer.activeChunks()
+                      << ", generierte Chunks: " << chunked.generatedChunks() << std::endl;
+        });
+        return 0;
     }
 
-    exportSVG(polygons, "track.svg", solutionEdges, DIM);
-    std::ofstream out(output_file);
-    out << "#include <iostream>\n#include <list>\n#include <cmath>\n#include <vector>\n#include <unordered_map>\n\n#include \"maze_generator.h\"\n\n";
-    out << "void MazeGenerator::generateMaze() {\n";
-    int idx = 0;
-    for (const auto& poly : polygons) {
-        out << "    Mazepolygon poly" << idx << ";\n";
-        out << "    poly" << idx << ".coordinates = {";
-        for (const auto& coord : poly.coordinates) {
-            out << "{" << std::fixed << std::setprecision(5) << coord.x << "f, " 
-                << coord.y << "f}, ";
+    // out-of-core storage uses the tiled layout unless asked otherwise
+    std::string storage_path = cmd.get("storage", "");
+    std::string layout_name = cmd.get("layout", storage_path.empty() ? "row-major" : "morton");
+    GridLayout layout = layout_name == "morton" ? GridLayout::Morton : GridLayout::RowMajor;
+    if (layout_name != "morton" && layout_name != "row-major") {
+        std::cerr << "Unknown grid layout: " << layout_name << std::endl;
+        return 1;
+    }
+    bool streaming = cmd.has("stream");
+    if (streaming && cmd.has("algorithm") && algorithm != "eller") {
+        std::cerr << "--stream only works with the eller algorithm" << std::endl;
+        return 1;
+    }
+    // grid size and shape mask, the size defaults to the mask image
+    std::string mask_file = cmd.get("mask", "");
+    PgmImage mask_image;
+    if (!mask_file.empty() && !loadPgm(mask_file, mask_image)) {
+        std::cerr << "Cannot read PGM mask " << mask_file << std::endl;
+        return 1;
+    }
+    const int width = std::stoi(cmd.get("width", std::to_string(mask_file.empty() ? grid_size : mask_image.width)));
+    const int height = std::stoi(cmd.get("height", std::to_string(mask_file.empty() ? grid_size : mask_image.height)));
+    if (width < 1 || height < 1) {
+        std::cerr << "The grid needs a width and height of at least 1" << std::endl;
+        return 1;
+    }
+    std::unique_ptr<ShapeMask> mask;
+    if (!mask_file.empty()) {
+        if (streaming || algorithm != "dfs") {
+            std::cerr << "--mask only works with the dfs algorithm" << std::endl;
+            return 1;
+        }
+        mask = std::make_unique<ShapeMask>(mask_image, width, height);
+        if (mask->freeCount() == 0) {
+            std::cerr << "Die Maske " << mask_file << " enthält keine freie Zelle" << std::endl;
+            return 1;
         }
-        out << "};\n";
-        out << "    polygons.push_back(poly" << idx << ");\n";
-        idx++;
     }
-
-    // Build a mapping from node coordinates to their indices and count occurrences
-    std::map<std::pair<int, int>, int> coord_to_index;
-    std::map<std::pair<int, int>, int> coord_count;
-    int node_idx = 1;
-    for (const auto& edge : solutionEdges) {
-        coord_to_index[edge.first] = node_idx;
-        coord_count[edge.first]++;
-        node_idx++;
+    // checkpoints, the key ties a checkpoint to the parameters of its run
+    std::string checkpoint_file = cmd.get("checkpoint", "");
+    const bool checkpointing = !checkpoint_file.empty();
+    const auto checkpoint_interval = std::chrono::duration<double>(std::stod(cmd.get("checkpoint-interval", "300")));
+    if (cmd.has("resume") && !checkpointing) {
+        std::cerr << "--resume needs --checkpoint <file>" << std::endl;
+        return 1;
     }
-    // Write SolutionGraphNodes
-    int j = 0;
-    for (const auto& edge : solutionEdges) {
-        j++;
-        out << "    SolutionGraphNode node" << j << ";\n";
+    if (checkpointing && (streaming || algorithm != "dfs")) {
+        std::cerr << "--checkpoint only works with the dfs algorithm" << std::endl;
+        return 1;
     }
-    // Write coordinates and neighbors
-    int i = 0;
-    for (const auto& edge : solutionEdges) {
-        i++;
-        out << "    node" << i << ".coordinate = {" << edge.first.first + 0.5f << "f, " << edge.first.second + 0.5f << "f};\n";
-        // Determine neighbors
-        auto curr = edge.first;
-        int prev_idx = (i > 1) ? i - 1 : -1;
-        int next_idx = (i < solutionEdges.size()) ? i + 1 : -1;
-        if (coord_count[curr] == 1) {
-            // Dead end: only previous neighbor
-            if (prev_idx > 0)
-                out << "    node" << i << ".neighbors.push_back(&node" << prev_idx << ");\n";
-        } else {
-            // Normal: previous and next neighbor
-            if (prev_idx > 0)
-                out << "    node" << i << ".neighbors.push_back(&node" << prev_idx << ");\n";
-            if (next_idx > 0 && next_idx <= solutionEdges.size())
-                out << "    node" << i << ".neighbors.push_back(&node" << next_idx << ");\n";
+    const std::string checkpoint_key = output_file + " " + std::to_string(width) + "x" + std::to_string(height) + " " +
+                                       std::to_string(crossing_probability) + " " + std::to_string(seed) + " " + rng_engine +
+                                       " " + layout_name + " " + mask_file + " " + tileset_file + " " +
+                                       std::to_string(fileHash(tileset_file)) + (cmd.has("no-macros") ? " no-macros" : "");
+    std::unique_ptr<CheckpointReader> checkpoint;
+    LoaderWriter::State loader_state{};
+    SvgWriter::State svg_state{};
+    int first_row = 0;
+    if (cmd.has("resume")) {
+        checkpoint = std::make_unique<CheckpointReader>(checkpoint_file);
+        if (!checkpoint->valid() || checkpoint->key() != checkpoint_key) {
+            std::cerr << "Checkpoint " << checkpoint_file << " fehlt oder passt nicht zu den Parametern" << std::endl;
+            return 1;
+        }
+        if (checkpoint->phase() == CHECKPOINT_OUTPUT) {
+            checkpoint->read(loader_state);
+            checkpoint->read(svg_state);
+            checkpoint->read(first_row);
         }
-        out << "    solutionGraph.push_back(node" << i << ");\n";
+        std::cout << "Setze fort aus " << checkpoint_file << "\n";
+    }
+    if (checkpointing) {
+        std::signal(SIGINT, [](int) { stopRequested = 1; });
+        std::signal(SIGTERM, [](int) { stopRequested = 1; });
     }
-    out << "}\n";
-    out.close();
+    const bool resume_output = checkpoint && checkpoint->phase() == CHECKPOINT_OUTPUT;
+
+    TileLookup tileLookup = buildTileLookup(tileset);
+    const uint64_t variant_seed = streamSeed(seed, STREAM_VARIANTS);
+    CrossingSampler crossings(crossing_probability, streamSeed(seed, STREAM_CROSSINGS), width, height, mask.get());
+    LoaderWriter loader(output_file, resume_output ? &loader_state : nullptr);
+    SvgWriter svg("track.svg", width, height, resume_output ? &svg_state : nullptr);
+    if (!loader.good()) {
+        std::cerr << "Cannot write " << output_file << std::endl;
+        return 1;
+    }
+
+    // tiles, polygons and solution graph of one row
+    std::vector<unsigned> rowWalls(width);
+    std::vector<int> rowTiles(width);
+    std::unique_ptr<TileGrid> tile_grid; // set if the tiles were placed by wfc instead of matching the walls
+    std::unique_ptr<MacroLayout> macro_layout; // macro tiles of the whole maze, their cells get no single tile
+    size_t next_macro = 0;
+    auto writeRow = [&](const MazeGrid& grid, int row, int y) {
+        for (int x = 0; x < width; ++x) {
+            rowWalls[x] = grid.wallMask(x, row);
+            rowTiles[x] = tile_grid ? tile_grid->at(x, y)
+                                    : tileLookup.variant(rowWalls[x], hashRandom(variant_seed, static_cast<uint64_t>(y) * width + x));
+        }
+        if (macro_layout) {
+            for (int x = 0; x < width; ++x) {
+                if (macro_layout->covered(x, y)) rowTiles[x] = -1;
+            }
+            writeMacroRow(tileset.macros, macro_layout->placements(), next_macro, y, loader, svg);
+        }
+        writeTrackRow(tiles, rowWalls.data(), rowTiles.data(), y, width, loader, svg);
+    };
+
+    timer.stage("setup");
+
+    if (streaming) {
+        // Eller's algorithm only needs the previous row, so generation,
+        // crossings and output run row by row in a two row window
+        MazeGrid window(width, 2);
+        withRngEngine(rng_engine, streamSeed(seed, STREAM_GENERATION), [&](auto& rng) {
+            EllerRowGenerator eller(width);
+            CrossingPass crossing_pass(crossings);
+            for (int y = 0; y < height; ++y) {
+                if (y >= 2) window.shiftRowsUp();
+                int row = std::min(y, 1);
+                eller.nextRow(window, row, y == height - 1, rng);
+                crossing_pass.apply(window, row, y);
+                writeRow(window, row, y);
+            }
+        });
+        timer.stage("streamed generation", static_cast<size_t>(width) * height);
+    } else {
+        // generate maze
+        std::unique_ptr<MazeGrid> grid;
+        try {
+            grid = std::make_unique<MazeGrid>(width, height, layout, storage_path);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        MazeGrid& maze = *grid;
+        if (mask) {
+            mask->blockCells(maze);
+            timer.stage("mask", static_cast<size_t>(width) * height);
+        }
+        auto last_checkpoint = std::chrono::steady_clock::now();
+        // true when a checkpoint is due, either by time or because a stop was requested
+        auto checkpointDue = [&] {
+            return stopRequested || std::chrono::steady_clock::now() - last_checkpoint >= checkpoint_interval;
+        };
+        // saves the checkpoint, exits without running destructors on a stop
+        // request so the output and spool files stay for --resume
+        auto commitCheckpoint = [&](CheckpointWriter& writer) {
+            if (!writer.commit()) std::cerr << "Cannot write checkpoint " << checkpoint_file << std::endl;
+            last_checkpoint = std::chrono::steady_clock::now();
+            if (stopRequested) {
+                std::cout << "Checkpoint in " << checkpoint_file << " gespeichert, fortsetzen mit --resume" << std::endl;
+                std::exit(2);
+            }
+        };
+        auto saveOutputCheckpoint = [&](int next_row) {
+            CheckpointWriter writer(checkpoint_file, checkpoint_key, CHECKPOINT_OUTPUT);
+            writer.write(loader.state());
+            writer.write(svg.state());
+            writer.write(next_row);
+            maze.save(writer.stream());
+            commitCheckpoint(writer);
+        };
+
+        withRngEngine(rng_engine, streamSeed(seed, STREAM_GENERATION), [&](auto& rng) {
+            if (resume_output) return;
+            if (tile_algorithm) {
+                tile_grid = std::make_unique<TileGrid>(width, height);
+                bool solved;
+                if (algorithm == "wfc") {
+                    WaveFunctionCollapse wfc(tileset, width, height);
+                    solved = wfc.run(rng);
+                    if (solved) wfc.copyTo(*tile_grid, 0, 0);
+                } else {
+                    solved = generateTilesParallel(tileset, *tile_grid, rng, algorithm_options);
+                }
+                if (!solved) {
+                    std::cerr << "WFC hat keine Lösung gefunden, das Tileset füllt das Gitter nicht" << std::endl;
+                    std::exit(1);
+                }
+                applyTileWalls(tileset, *tile_grid, maze);
+                return;
+            }
+            if (!checkpointing) {
+                findMazeAlgorithm<std::decay_t<decltype(rng)>>(algorithm)(maze, rng, algorithm_options);
+                return;
+            }
+            // depth-first search with periodic checkpoints of the search state
+            // starts at the first free cell, blocked cells are visited already
+            const MazeRegion region{0, 0, width, height};
+            int start_x = 0, start_y = 0;
+            findUnvisited(maze, region, start_x, start_y);
+            DepthFirstState dfs(maze, region, start_x, start_y);
+            if (checkpoint) {
+                auto& in = checkpoint->stream();
+                bool ok = checkpoint->read(dfs.x) && checkpoint->read(dfs.y) && checkpoint->read(rng) &&
+                          dfs.path.load(in) && maze.load(in);
+                if (!ok) {
+                    std::cerr << "Checkpoint " << checkpoint_file << " ist unvollständig" << std::endl;
+                    std::exit(1);
+                }
+            }
+            runDepthFirstComponents(maze, rng, dfs, [&] {
+                if (!checkpointDue()) return true;
+                CheckpointWriter writer(checkpoint_file, checkpoint_key, CHECKPOINT_GENERATION);
+                writer.write(dfs.x);
+                writer.write(dfs.y);
+                writer.write(rng);
+                dfs.path.save(writer.stream());
+                maze.save(writer.stream());
+                commitCheckpoint(writer);
+                return true;
+            });
+        });
+        const size_t cells = static_cast<size_t>(width) * height;
+        timer.stage("generation", cells);
+        if (resume_output) {
+            if (!maze.load(checkpoint->stream())) {
+                std::cerr << "Checkpoint " << checkpoint_file << " ist unvollständig" << std::endl;
+                return 1;
+            }
+        } else if (!tile_grid) {
+            addCrossings(maze, crossings, threads);
+            if (checkpointing) saveOutputCheckpoint(0);
+        }
+        timer.stage("crossings", cells);
+        if (!tile_grid && !tileset.macros.empty() && !cmd.has("no-macros")) {
+            // the layout only depends on the maze, a resumed run places the same tiles
+            macro_layout = std::make_unique<MacroLayout>(placeMacroTiles(maze, buildMacroTemplates(tileset)));
+            timer.stage("macro tiles", cells);
+        }
+        if (cmd.has("hash")) {
+            std::cout << "Maze-Hash: " << std::hex << std::setw(16) << std::setfill('0') << maze.hash()
+                      << std::dec << std::setfill(' ') << "\n";
+        }
+        for (int y = first_row; y < height; ++y) {
+            writeRow(maze, y, y);
+            if (checkpointing && y + 1 < height && checkpointDue()) saveOutputCheckpoint(y + 1);
+        }
+        timer.stage("tiles and output", cells);
+    }
+
+    loader.finish();
+    svg.finish();
+    if (checkpointing) std::remove(checkpoint_file.c_str());
+    timer.stage("export");
     std::cout << "SVG-Visualisierung in track.svg gespeichert.\n";
     std::cout << "Track generiert und in " << output_file << " geschrieben.\n";
-    std::cout << "Anzahl der generierten Polygone: " << polygons.size() << "\n";
+    std::cout << "Anzahl der generierten Polygone: " << loader.polygonCount() << "\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,713 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "maze_grid.h"
+#include "parallel.h"
+#include "random.h"
+
+/**
+ * Maze generation algorithms.
+ *
+ * Every algorithm carves a perfect maze (a spanning tree over all cells)
+ * into a MazeGrid whose walls are all closed and whose visited bits are all
+ * cleared. They share the MazeAlgorithm signature and are looked up by name
+ * through findMazeAlgorithm(). The depth-first search (generateMaze) also
+ * takes grids with cells marked visited beforehand and never enters them,
+ * which is how cells outside a shape mask are left out.
+ */
+
+/**
+ * @brief Tuning parameters of the algorithms.
+ * @var growingTreeNewest: probability that growing tree continues from the
+ *      newest active cell (1 = depth-first, 0 = Prim-like random choice)
+ * @var threads: worker threads of the parallel algorithms
+ * @var regionSize: edge length of the regions of parallel-dfs, the width is
+ *      rounded up to a multiple of 64
+ */
+struct MazeAlgorithmOptions {
+    float growingTreeNewest = 0.5f;
+    unsigned threads = 1;
+    int regionSize = 256;
+};
+
+/**
+ * @brief Rectangle of cells [x0, x1) x [y0, y1).
+ */
+struct MazeRegion {
+    int x0, y0, x1, y1;
+    bool contains(int x, int y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+};
+
+template <class Rng>
+using MazeAlgorithm = void (*)(MazeGrid&, Rng&, const MazeAlgorithmOptions&);
+
+// all 24 orders of the four directions, a random order costs one draw
+constexpr uint8_t DIR_PERMUTATIONS[24][4] = {
+    {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {0, 3, 2, 1},
+    {1, 0, 2, 3}, {1, 0, 3, 2}, {1, 2, 0, 3}, {1, 2, 3, 0}, {1, 3, 0, 2}, {1, 3, 2, 0},
+    {2, 0, 1, 3}, {2, 0, 3, 1}, {2, 1, 0, 3}, {2, 1, 3, 0}, {2, 3, 0, 1}, {2, 3, 1, 0},
+    {3, 0, 1, 2}, {3, 0, 2, 1}, {3, 1, 0, 2}, {3, 1, 2, 0}, {3, 2, 0, 1}, {3, 2, 1, 0},
+};
+
+/**
+ * @brief Picks a random direction towards an unvisited neighbour.
+ * @return The direction, or -1 if all neighbours are visited.
+ */
+template <class Rng>
+int randomUnvisitedDirection(const MazeGrid& maze, int x, int y, Rng& rng) {
+    int dirs[4];
+    int count = 0;
+    for (int d = 0; d < 4; ++d) {
+        int nx = x + DIR_DX[d], ny = y + DIR_DY[d];
+        if (maze.contains(nx, ny) && !maze.isVisited(nx, ny)) dirs[count++] = d;
+    }
+    return count == 0 ? -1 : dirs[uniformInt(rng, count)];
+}
+
+/**
+ * @brief Backtracking path of a depth-first search as 2 bit directions.
+ *
+ * Every step of the search moves to a neighbour, so the path is stored as
+ * the directions taken and the current cell is moved back by the opposite
+ * direction when popping. Needs 2 bits per step instead of a coordinate pair.
+ * The buffer is sized for the longest possible path up front; pages are
+ * only touched once the path gets that deep.
+ */
+class DirectionStack {
+public:
+    /**
+     * @param capacity Maximum number of steps.
+     * @param path Backing file for out-of-core generation, empty for the heap.
+     */
+    explicit DirectionStack(size_t capacity, const std::string& path = "") : words_((capacity + 31) / 32, path) {}
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    void push(int dir) {
+        uint64_t& word = words_[size_ / 32];
+        unsigned shift = (size_ & 31) * 2;
+        word = (word & ~(uint64_t(3) << shift)) | (uint64_t(dir) << shift);
+        ++size_;
+    }
+
+    int pop() {
+        --size_;
+        return static_cast<int>((words_[size_ / 32] >> ((size_ & 31) * 2)) & 3);
+    }
+
+    /**
+     * @brief Writes the path in binary form, see load().
+     */
+    void save(std::ostream& out) const {
+        uint64_t size = size_;
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(words_.data()), (size_ + 31) / 32 * sizeof(uint64_t));
+    }
+
+    /**
+     * @brief Restores a path written by save().
+     * @return false if the data is truncated or does not fit the capacity.
+     */
+    bool load(std::istream& in) {
+        uint64_t size = 0;
+        if (!in.read(reinterpret_cast<char*>(&size), sizeof(size))) return false;
+        if ((size + 31) / 32 > words_.size()) return false;
+        size_ = size;
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(words_.data()), (size_ + 31) / 32 * sizeof(uint64_t)));
+    }
+
+private:
+    WordBuffer words_;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief A running depth-first search: the region, the current cell and the
+ * backtracking path. Together with the grid and the random engine this is
+ * everything needed to continue the search, e.g. from a checkpoint.
+ */
+struct DepthFirstState {
+    /**
+     * @brief Starts a search in the top left cell of the region and marks
+     * that cell visited.
+     */
+    DepthFirstState(MazeGrid& maze, const MazeRegion& region) : DepthFirstState(maze, region, region.x0, region.y0) {}
+
+    /**
+     * @brief Starts a search in the cell (startX, startY) of the region and
+     * marks that cell visited.
+     */
+    DepthFirstState(MazeGrid& maze, const MazeRegion& region, int startX, int startY)
+        : region(region),
+          path(static_cast<size_t>(region.x1 - region.x0) * (region.y1 - region.y0),
+               maze.storageFile(".stack" + std::to_string(region.x0) + "_" + std::to_string(region.y0))),
+          x(startX), y(startY) {
+        maze.markVisited(x, y);
+    }
+
+    /**
+     * @brief Starts the next search of a finished one in the cell (startX,
+     * startY), reusing the path buffer.
+     */
+    void restart(MazeGrid& maze, int startX, int startY) {
+        x = startX;
+        y = startY;
+        maze.markVisited(x, y);
+    }
+
+    MazeRegion region;
+    DirectionStack path;
+    int x, y;
+};
+
+/**
+ * @brief Runs a depth-first search until its region is complete.
+ *
+ * hook() is called between two steps every 65536 steps; returning false
+ * pauses the search, which can be continued later by calling this again.
+ * The loop itself does not allocate: the neighbour order is a row of
+ * DIR_PERMUTATIONS and the path buffer is sized for the region up front.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ * @param state The search to continue.
+ * @param hook Callable returning whether to go on.
+ * @return true if the search finished, false if it was paused.
+ */
+template <class Rng, class Hook>
+bool runDepthFirst(MazeGrid& maze, Rng& rng, DepthFirstState& state, Hook&& hook) {
+    const MazeRegion& region = state.region;
+    DirectionStack& path = state.path;
+    int x = state.x, y = state.y;
+    for (uint32_t step = 1;; ++step) {
+        if ((step & 0xffff) == 0) {
+            state.x = x;
+            state.y = y;
+            if (!hook()) return false;
+        }
+        const uint8_t* dirs = DIR_PERMUTATIONS[uniformInt(rng, 24)];
+        bool moved = false;
+        for (int i = 0; i < 4; ++i) {
+            int dir = dirs[i];
+            int nx = x + DIR_DX[dir], ny = y + DIR_DY[dir];
+            if (region.contains(nx, ny) && !maze.isVisited(nx, ny)) {
+                maze.removeWall(x, y, dir);
+                maze.markVisited(nx, ny);
+                path.push(dir);
+                x = nx;
+                y = ny;
+                moved = true;
+                break;
+            }
+        }
+        if (moved) continue;
+        if (path.empty()) break;
+        // back to the previous cell
+        int back = (path.pop() + 2) % 4;
+        x += DIR_DX[back];
+        y += DIR_DY[back];
+    }
+    state.x = x;
+    state.y = y;
+    return true;
+}
+
+/**
+ * @brief Finds the first unvisited cell of the region in row-major order,
+ * starting at row y. The visited flags are tested 64 cells at a time.
+ * @return false if all cells from row y on are visited, x and y are then
+ *         unchanged.
+ */
+inline bool findUnvisited(const MazeGrid& maze, const MazeRegion& region, int& x, int& y) {
+    for (int row = y; row < region.y1; ++row) {
+        for (int x0 = region.x0 & ~63; x0 < region.x1; x0 += 64) {
+            uint64_t bits = ~maze.visitedRowWord(row, x0);
+            if (x0 < region.x0) bits &= ~uint64_t(0) << (region.x0 - x0);
+            if (region.x1 - x0 < 64) bits &= (uint64_t(1) << (region.x1 - x0)) - 1;
+            if (bits) {
+                x = x0 + __builtin_ctzll(bits);
+                y = row;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Runs depth-first searches until every cell of the region is
+ * visited. When a search is done the next one starts at the first cell it
+ * could not reach, so cells that were marked visited before (blocked cells)
+ * may split the region into several parts, each gets its own spanning tree.
+ * Without blocked cells this is a single runDepthFirst().
+ *
+ * @return true if all searches finished, false if one was paused by hook().
+ */
+template <class Rng, class Hook>
+bool runDepthFirstComponents(MazeGrid& maze, Rng& rng, DepthFirstState& state, Hook&& hook) {
+    for (;;) {
+        if (!runDepthFirst(maze, rng, state, hook)) return false;
+        // a finished search is back at its start, all cells before it were visited already
+        int x = state.x, y = state.y;
+        if (!findUnvisited(maze, state.region, x, y)) return true;
+        state.restart(maze, x, y);
+    }
+}
+
+/**
+ * @brief Depth-first search that stays inside a region of the maze, carves a
+ * spanning tree over the cells of the region.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ * @param region The cells the search may visit.
+ */
+template <class Rng>
+void generateMazeInRegion(MazeGrid& maze, Rng& rng, const MazeRegion& region) {
+    DepthFirstState state(maze, region);
+    runDepthFirst(maze, rng, state, [] { return true; });
+}
+
+/**
+ * @brief Generates a random maze using depth-first search.
+ *
+ * Cells that are already visited are left out, the search starts at the
+ * first unvisited cell and every part of the remaining cells becomes a
+ * perfect maze of its own.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ */
+template <class Rng>
+void generateMaze(MazeGrid& maze, Rng& rng, const MazeAlgorithmOptions& = {}) {
+    const MazeRegion region{0, 0, maze.width(), maze.height()};
+    int x = 0, y = 0;
+    if (!findUnvisited(maze, region, x, y)) return;
+    DepthFirstState state(maze, region, x, y);
+    runDepthFirstComponents(maze, rng, state, [] { return true; });
+}
+
+/**
+ * @brief Parallel depth-first search over rectangular regions.
+ *
+ * The grid is split into regions, every region gets its own depth-first
+ * spanning tree on a worker thread. The regions are then joined by a random
+ * spanning tree over the region graph (Kruskal on the shuffled region
+ * borders), each chosen border gets one opening at a random position, so
+ * the result is again a perfect maze.
+ *
+ * Region widths are multiples of 64 cells and heights multiples of the
+ * grid's row alignment, so two regions never write the same word of the
+ * MazeGrid bitplanes. The region seeds are drawn from rng
+ * up front, the maze does not depend on the number of threads.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ * @param options regionSize and threads.
+ */
+template <class Rng>
+void generateParallelRegions(MazeGrid& maze, Rng& rng, const MazeAlgorithmOptions& options = {}) {
+    const int W = maze.width(), H = maze.height();
+    const int regionW = std::max(64, (options.regionSize + 63) / 64 * 64);
+    const int align = maze.rowAlignment();
+    const int regionH = std::max(align, (options.regionSize + align - 1) / align * align);
+    const int cols = (W + regionW - 1) / regionW, rows = (H + regionH - 1) / regionH;
+    auto region = [&](int r) {
+        int cx = r % cols, cy = r / cols;
+        return MazeRegion{cx * regionW, cy * regionH, std::min(W, (cx + 1) * regionW), std::min(H, (cy + 1) * regionH)};
+    };
+    std::vector<uint64_t> seeds(static_cast<size_t>(cols) * rows);
+    for (auto& s : seeds) s = rng();
+    parallelFor(seeds.size(), options.threads, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            Rng regionRng(seeds[r]);
+            generateMazeInRegion(maze, regionRng, region(static_cast<int>(r)));
+        }
+    });
+    // stitch the regions, border id = 2 * region + d for the right (d = 0)
+    // and lower (d = 1) neighbour region
+    std::vector<int> parent(seeds.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int c) {
+        while (parent[c] != c) {
+            parent[c] = parent[parent[c]];
+            c = parent[c];
+        }
+        return c;
+    };
+    std::vector<uint32_t> borders;
+    for (int r = 0; r < cols * rows; ++r) {
+        if (r % cols + 1 < cols) borders.push_back(2 * r);
+        if (r / cols + 1 < rows) borders.push_back(2 * r + 1);
+    }
+    shuffleRange(borders.begin(), borders.end(), rng);
+    for (uint32_t border : borders) {
+        int r = border >> 1;
+        int d = border & 1;
+        int a = find(r), b = find(d == 0 ? r + 1 : r + cols);
+        if (a == b) continue;
+        parent[a] = b;
+        MazeRegion rect = region(r);
+        if (d == 0) maze.removeWall(rect.x1 - 1, rect.y0 + uniformInt(rng, rect.y1 - rect.y0), 0);
+        else maze.removeWall(rect.x0 + uniformInt(rng, rect.x1 - rect.x0), rect.y1 - 1, 1);
+    }
+}
+
+/**
+ * @brief Kruskal on cell ids of type Id, see generateKruskal.
+ */
+template <class Id, class Rng>
+void generateKruskalIds(MazeGrid& maze, Rng& rng) {
+    const Id W = maze.width(), H = maze.height();
+    std::vector<Id> parent(static_cast<size_t>(W) * H);
+    std::iota(parent.begin(), parent.end(), Id(0));
+    auto find = [&parent](Id c) {
+        while (parent[c] != c) {
+            parent[c] = parent[parent[c]]; // path halving
+            c = parent[c];
+        }
+        return c;
+    };
+    // wall id = 2 * cell + d for the right (d = 0) and down (d = 1) wall
+    std::vector<Id> walls;
+    walls.reserve(2 * parent.size());
+    for (Id y = 0; y < H; ++y) {
+        for (Id x = 0; x < W; ++x) {
+            Id cell = y * W + x;
+            if (x + 1 < W) walls.push_back(2 * cell);
+            if (y + 1 < H) walls.push_back(2 * cell + 1);
+        }
+    }
+    shuffleRange(walls.begin(), walls.end(), rng);
+    for (Id wall : walls) {
+        Id cell = wall >> 1;
+        int d = static_cast<int>(wall & 1);
+        Id next = d == 0 ? cell + 1 : cell + W;
+        Id a = find(cell), b = find(next);
+        if (a == b) continue;
+        parent[a] = b;
+        maze.removeWall(static_cast<int>(cell % W), static_cast<int>(cell / W), d);
+    }
+    for (int y = 0; y < maze.height(); ++y) {
+        for (int x = 0; x < maze.width(); ++x) maze.markVisited(x, y);
+    }
+}
+
+/**
+ * @brief Randomized Kruskal: all inner walls in random order, a wall is
+ * removed if it joins two different trees of a union-find.
+ *
+ * Cell and wall ids are 32 bit as long as every wall id fits, larger grids
+ * switch to 64 bit ids (twice the memory) instead of wrapping around.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ */
+template <class Rng>
+void generateKruskal(MazeGrid& maze, Rng& rng, const MazeAlgorithmOptions& = {}) {
+    const uint64_t cells = static_cast<uint64_t>(maze.width()) * maze.height();
+    if (cells <= UINT32_MAX / 2) generateKruskalIds<uint32_t>(maze, rng);
+    else generateKruskalIds<uint64_t>(maze, rng);
+}
+
+/**
+ * @brief Wilson's algorithm: loop-erased random walks from every cell not yet
+ * in the tree, gives a uniform spanning tree.
+ *
+ * Only the last exit direction of every cell is stored (one byte per cell),
+ * revisiting a cell overwrites it which erases the loop.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ */
+template <class Rng>
+void generateWilson(MazeGrid& maze, Rng& rng, const MazeAlgorithmOptions& = {}) {
+    const int W = maze.width(), H = maze.height();
+    std::vector<uint8_t> exitDir(static_cast<size_t>(W) * H);
+    maze.markVisited(uniformInt(rng, W), uniformInt(rng, H));
+    for (int sy = 0; sy < H; ++sy) {
+        for (int sx = 0; sx < W; ++sx) {
+            if (maze.isVisited(sx, sy)) continue;
+            // random walk until the tree is hit
+            int x = sx, y = sy;
+            while (!maze.isVisited(x, y)) {
+                int d;
+                do {
+                    d = uniformInt(rng, 4);
+                } while (!maze.contains(x + DIR_DX[d], y + DIR_DY[d]));
+                exitDir[static_cast<size_t>(y) * W + x] = static_cast<uint8_t>(d);
+                x += DIR_DX[d];
+                y += DIR_DY[d];
+            }
+            // carve the loop-erased path
+            x = sx;
+            y = sy;
+            while (!maze.isVisited(x, y)) {
+                int d = exitDir[static_cast<size_t>(y) * W + x];
+                maze.markVisited(x, y);
+                maze.removeWall(x, y, d);
+                x += DIR_DX[d];
+                y += DIR_DY[d];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Randomized Prim: grows the tree from a random frontier cell, which
+ * is connected to a random neighbour already inside the tree.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ */
+template <class Rng>
+void generatePrim(MazeGrid& maze, Rng& rng, const MazeAlgorithmOptions& = {}) {
+    const int W = maze.width(), H = maze.height();
+    std::vector<bool> inFrontier(static_cast<size_t>(W) * H, false);
+    std::vector<std::pair<int, int>> frontier;
+    auto add = [&](int x, int y) {
+        maze.markVisited(x, y);
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + DIR_DX[d], ny = y + DIR_DY[d];
+            if (!maze.contains(nx, ny) || maze.isVisited(nx, ny)) continue;
+            size_t idx = static_cast<size_t>(ny) * W + nx;
+            if (inFrontier[idx]) continue;
+            inFrontier[idx] = true;
+            frontier.push_back({nx, ny});
+        }
+    };
+    add(uniformInt(rng, W), uniformInt(rng, H));
+    while (!frontier.empty()) {
+        size_t i = uniformInt(rng, static_cast<uint32_t>(frontier.size()));
+        auto [x, y] = frontier[i];
+        frontier[i] = frontier.back();
+        frontier.pop_back();
+        // connect to a random neighbour inside the tree
+        int dirs[4];
+        int count = 0;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + DIR_DX[d], ny = y + DIR_DY[d];
+            if (maze.contains(nx, ny) && maze.isVisited(nx, ny)) dirs[count++] = d;
+        }
+        maze.removeWall(x, y, dirs[uniformInt(rng, count)]);
+        add(x, y);
+    }
+}
+
+/**
+ * @brief Growing tree: keeps a list of active cells and carves from either
+ * the newest one (probability options.growingTreeNewest) or a random one.
+ * Cells without unvisited neighbours leave the list.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ * @param options growingTreeNewest selects the mix of both policies.
+ */
+template <class Rng>
+void generateGrowingTree(MazeGrid& maze, Rng& rng, const MazeAlgorithmOptions& options = {}) {
+    const uint64_t newestThreshold = static_cast<uint64_t>(options.growingTreeNewest * 16777216.0);
+    std::vector<std::pair<int, int>> active;
+    int sx = uniformInt(rng, maze.width()), sy = uniformInt(rng, maze.height());
+    maze.markVisited(sx, sy);
+    active.push_back({sx, sy});
+    while (!active.empty()) {
+        size_t i = active.size() - 1;
+        if ((rng() >> 40) >= newestThreshold) i = uniformInt(rng, static_cast<uint32_t>(active.size()));
+        auto [x, y] = active[i];
+        int d = randomUnvisitedDirection(maze, x, y, rng);
+        if (d < 0) {
+            active[i] = active.back();
+            active.pop_back();
+            continue;
+        }
+        int nx = x + DIR_DX[d], ny = y + DIR_DY[d];
+        maze.removeWall(x, y, d);
+        maze.markVisited(nx, ny);
+        active.push_back({nx, ny});
+    }
+}
+
+/**
+ * @brief Hunt-and-kill: random walk into unvisited cells until stuck, then
+ * scan for an unvisited cell next to the tree and continue from there. Needs
+ * no memory besides the grid.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ */
+template <class Rng>
+void generateHuntAndKill(MazeGrid& maze, Rng& rng, const MazeAlgorithmOptions& = {}) {
+    const int W = maze.width(), H = maze.height();
+    int x = uniformInt(rng, W), y = uniformInt(rng, H);
+    maze.markVisited(x, y);
+    int huntRow = 0; // rows above are completely visited
+    while (true) {
+        int d = randomUnvisitedDirection(maze, x, y, rng);
+        if (d >= 0) {
+            maze.removeWall(x, y, d);
+            x += DIR_DX[d];
+            y += DIR_DY[d];
+            maze.markVisited(x, y);
+            continue;
+        }
+        // hunt
+        bool found = false;
+        bool complete = true; // all rows scanned so far are visited
+        for (int hy = huntRow; hy < H && !found; ++hy) {
+            bool rowComplete = true;
+            for (int hx = 0; hx < W && !found; ++hx) {
+                if (maze.isVisited(hx, hy)) continue;
+                rowComplete = false;
+                int dirs[4];
+                int count = 0;
+                for (int n = 0; n < 4; ++n) {
+                    int nx = hx + DIR_DX[n], ny = hy + DIR_DY[n];
+                    if (maze.contains(nx, ny) && maze.isVisited(nx, ny)) dirs[count++] = n;
+                }
+                if (count == 0) continue;
+                x = hx;
+                y = hy;
+                maze.removeWall(x, y, dirs[uniformInt(rng, count)]);
+                maze.markVisited(x, y);
+                found = true;
+            }
+            if (rowComplete && complete) huntRow = hy + 1;
+            else complete = false;
+        }
+        if (!found) break;
+    }
+}
+
+/**
+ * @brief Eller's algorithm, generates the maze one row at a time and only
+ * keeps the set membership of the current row, O(width) memory.
+ *
+ * Every call of nextRow() carves the right walls of a row and the down walls
+ * into the following row. Set ids are compacted to [0, width) per row and
+ * merged with a small union-find.
+ */
+class EllerRowGenerator {
+public:
+    explicit EllerRowGenerator(int width)
+        : set_(width, -1), parent_(width), remap_(width), down_(width),
+          hasDown_(width), seen_(width), chosen_(width) {}
+
+    /**
+     * @brief Carves the next row.
+     *
+     * @param maze The grid holding the row.
+     * @param row The row inside the grid.
+     * @param lastRow Joins all remaining sets and carves nothing downwards.
+     * @param rng The random number generator.
+     */
+    template <class Rng>
+    void nextRow(MazeGrid& maze, int row, bool lastRow, Rng& rng) {
+        const int W = maze.width();
+        // compact the ids carried over, cells without set get a new one
+        std::fill(remap_.begin(), remap_.end(), -1);
+        int sets = 0;
+        for (int x = 0; x < W; ++x) {
+            if (set_[x] < 0) continue;
+            if (remap_[set_[x]] < 0) remap_[set_[x]] = sets++;
+            set_[x] = remap_[set_[x]];
+        }
+        for (int x = 0; x < W; ++x) {
+            if (set_[x] < 0) set_[x] = sets++;
+        }
+        for (int i = 0; i < sets; ++i) parent_[i] = i;
+        // join neighbouring cells of different sets
+        for (int x = 0; x + 1 < W; ++x) {
+            int a = find(set_[x]), b = find(set_[x + 1]);
+            if (a == b || !(lastRow || (rng() >> 63))) continue;
+            maze.removeWall(x, row, 0);
+            parent_[b] = a;
+        }
+        for (int x = 0; x < W; ++x) set_[x] = find(set_[x]);
+        if (lastRow) return;
+        // every set continues downwards at least once
+        std::fill(hasDown_.begin(), hasDown_.begin() + sets, 0);
+        std::fill(seen_.begin(), seen_.begin() + sets, 0);
+        for (int x = 0; x < W; ++x) {
+            down_[x] = static_cast<uint8_t>(rng() >> 63);
+            if (down_[x]) hasDown_[set_[x]] = 1;
+        }
+        for (int x = 0; x < W; ++x) {
+            int s = set_[x];
+            if (!hasDown_[s] && uniformInt(rng, ++seen_[s]) == 0) chosen_[s] = x;
+        }
+        for (int x = 0; x < W; ++x) {
+            int s = set_[x];
+            if (!hasDown_[s] && chosen_[s] == x) down_[x] = 1;
+            if (down_[x]) maze.removeWall(x, row, 1);
+            else set_[x] = -1;
+        }
+    }
+
+private:
+    int find(int s) {
+        while (parent_[s] != s) {
+            parent_[s] = parent_[parent_[s]];
+            s = parent_[s];
+        }
+        return s;
+    }
+
+    std::vector<int> set_;
+    std::vector<int> parent_;
+    std::vector<int> remap_;
+    std::vector<uint8_t> down_;
+    std::vector<uint8_t> hasDown_;
+    std::vector<uint32_t> seen_;
+    std::vector<int> chosen_;
+};
+
+/**
+ * @brief Eller's algorithm on a complete grid.
+ *
+ * @param maze The maze to modify.
+ * @param rng The random number generator.
+ */
+template <class Rng>
+void generateEller(MazeGrid& maze, Rng& rng, const MazeAlgorithmOptions& = {}) {
+    EllerRowGenerator eller(maze.width());
+    for (int y = 0; y < maze.height(); ++y) {
+        eller.nextRow(maze, y, y == maze.height() - 1, rng);
+        for (int x = 0; x < maze.width(); ++x) maze.markVisited(x, y);
+    }
+}
+
+/**
+ * @brief Names of the registered algorithms, separated by '|'.
+ */
+inline const char* mazeAlgorithmNames() {
+    return "dfs|parallel-dfs|kruskal|wilson|prim|growing-tree|hunt-and-kill|eller";
+}
+
+/**
+ * @brief Looks up a maze algorithm by name.
+ * @return The algorithm, or nullptr if the name is unknown.
+ */
+template <class Rng>
+MazeAlgorithm<Rng> findMazeAlgorithm(const std::string& name) {
+    static const std::pair<const char*, MazeAlgorithm<Rng>> registry[] = {
+        {"dfs", &generateMaze<Rng>},
+        {"parallel-dfs", &generateParallelRegions<Rng>},
+        {"kruskal", &generateKruskal<Rng>},
+        {"wilson", &generateWilson<Rng>},
+        {"prim", &generatePrim<Rng>},
+        {"growing-tree", &generateGrowingTree<Rng>},
+        {"hunt-and-kill", &generateHuntAndKill<Rng>},
+        {"eller", &generateEller<Rng>},
+    };
+    for (const auto& entry : registry) {
+        if (name == entry.first) return entry.second;
+    }
+    return nullptr;
+}
@@ -0,0 +1,251 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include "word_buffer.h"
+
+// directions: 0: rechts, 1: unten, 2: links, 3: oben
+constexpr int DIR_DX[4] = {1, 0, -1, 0};
+constexpr int DIR_DY[4] = {0, 1, 0, -1};
+
+/**
+ * @brief Order of the cells in the bitplanes of a MazeGrid.
+ *
+ * RowMajor: rows padded to whole 64 bit words.
+ * Morton: every word holds an 8x8 tile of cells in Z-order, the tiles are
+ * stored row by row. A vertical step stays inside the same word for 7 of 8
+ * rows instead of jumping a whole row ahead.
+ */
+enum class GridLayout { RowMajor, Morton };
+
+/**
+ * @brief Contiguous maze grid with two passage bits per cell.
+ *
+ * Only the right and down connection of every cell is stored, the left/up
+ * walls are read from the neighbouring cell. The outer border is always
+ * closed. A separate bitmap holds the visited flags used by the generators.
+ * All stages access cells through x/y, the GridLayout only changes where a
+ * cell's bits live in memory.
+ *
+ * With a storage path the bitplanes live in memory-mapped files
+ * <path>.right, <path>.down and <path>.visited instead of on the heap, the
+ * generators put their scratch buffers next to them (see storagePath()).
+ */
+class MazeGrid {
+public:
+    MazeGrid(int width, int height, GridLayout layout = GridLayout::RowMajor, const std::string& storagePath = "")
+        : width_(width), height_(height), layout_(layout),
+          stride_(((static_cast<size_t>(width) + 63) / 64) * 64),
+          tilesPerRow_((static_cast<size_t>(width) + 7) / 8),
+          storagePath_(storagePath),
+          openRight_(wordCount(), storageFile(".right")), openDown_(wordCount(), storageFile(".down")),
+          visited_(wordCount(), storageFile(".visited")) {}
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    GridLayout layout() const { return layout_; }
+
+    /**
+     * @brief Base path of the memory-mapped storage, empty for heap storage.
+     */
+    const std::string& storagePath() const { return storagePath_; }
+
+    /**
+     * @brief Path of a file next to the storage, empty for heap storage.
+     */
+    std::string storageFile(const std::string& suffix) const {
+        return storagePath_.empty() ? std::string() : storagePath_ + suffix;
+    }
+
+    /**
+     * @brief Rows are grouped so no word spans two groups. Threads that
+     * write different rows must split them at multiples of this value, and
+     * at multiples of 64 columns.
+     */
+    int rowAlignment() const { return layout_ == GridLayout::Morton ? 8 : 1; }
+
+    bool contains(int x, int y) const {
+        return x >= 0 && x < width_ && y >= 0 && y < height_;
+    }
+
+    /**
+     * @brief Checks if the cell has a wall in the given direction.
+     */
+    bool hasWall(int x, int y, int dir) const {
+        switch (dir) {
+            case 0: return !testBit(openRight_, bitIndex(x, y));
+            case 1: return !testBit(openDown_, bitIndex(x, y));
+            case 2: return x == 0 || !testBit(openRight_, bitIndex(x - 1, y));
+            default: return y == 0 || !testBit(openDown_, bitIndex(x, y - 1));
+        }
+    }
+
+    /**
+     * @brief Removes the wall between the cell and its neighbour in the given
+     * direction. The neighbour has to be inside the grid.
+     */
+    void removeWall(int x, int y, int dir) {
+        switch (dir) {
+            case 0: setBit(openRight_, bitIndex(x, y)); break;
+            case 1: setBit(openDown_, bitIndex(x, y)); break;
+            case 2: setBit(openRight_, bitIndex(x - 1, y)); break;
+            default: setBit(openDown_, bitIndex(x, y - 1)); break;
+        }
+    }
+
+    /**
+     * @brief Opens the right (dir 0) or down (dir 1) walls of up to 64 cells
+     * of a row at once, bit i of bits stands for cell x0 + i. x0 has to be
+     * a multiple of 64 and the bits must not open the outer border.
+     */
+    void openRowBits(int y, int dir, int x0, uint64_t bits) {
+        if (!bits) return;
+        WordBuffer& plane = dir == 0 ? openRight_ : openDown_;
+        if (layout_ == GridLayout::RowMajor) {
+            plane[bitIndex(x0, y) >> 6] |= bits;
+            return;
+        }
+        while (bits) {
+            setBit(plane, bitIndex(x0 + __builtin_ctzll(bits), y));
+            bits &= bits - 1;
+        }
+    }
+
+    /**
+     * @brief The open right (dir 0) or down (dir 1) walls of 64 cells of a
+     * row, bit i stands for cell x0 + i. x0 has to be a multiple of 64,
+     * bits past the row end are 0.
+     */
+    uint64_t openRowWord(int y, int dir, int x0) const {
+        return rowWord(dir == 0 ? openRight_ : openDown_, y, x0);
+    }
+
+    /**
+     * @brief The visited flags of 64 cells of a row, like openRowWord().
+     */
+    uint64_t visitedRowWord(int y, int x0) const { return rowWord(visited_, y, x0); }
+
+    /**
+     * @brief Returns the closed walls of a cell as bitmask, bit d is set if
+     * there is a wall in direction d.
+     */
+    unsigned wallMask(int x, int y) const {
+        unsigned mask = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (hasWall(x, y, d)) mask |= 1u << d;
+        }
+        return mask;
+    }
+
+    /**
+     * @brief 64 bit FNV-1a hash over the passage bits, equal mazes have equal
+     * hashes.
+     */
+    uint64_t hash() const {
+        uint64_t h = 0xcbf29ce484222325ull;
+        auto mix = [&h](uint64_t word) {
+            for (int i = 0; i < 8; ++i) {
+                h ^= (word >> (8 * i)) & 0xff;
+                h *= 0x100000001b3ull;
+            }
+        };
+        mix(static_cast<uint64_t>(width_));
+        mix(static_cast<uint64_t>(height_));
+        if (layout_ == GridLayout::RowMajor) {
+            for (uint64_t w : openRight_) mix(w);
+            for (uint64_t w : openDown_) mix(w);
+            return h;
+        }
+        // same value as the row-major layout would give
+        for (const auto* bits : {&openRight_, &openDown_}) {
+            for (int y = 0; y < height_; ++y) {
+                for (size_t x0 = 0; x0 < stride_; x0 += 64) {
+                    uint64_t word = 0;
+                    for (size_t x = x0; x < std::min(x0 + 64, static_cast<size_t>(width_)); ++x) {
+                        word |= uint64_t(testBit(*bits, bitIndex(static_cast<int>(x), y))) << (x - x0);
+                    }
+                    mix(word);
+                }
+            }
+        }
+        return h;
+    }
+
+    /**
+     * @brief Drops the first row, moves all other rows up by one and clears
+     * the last row. Used to slide a small grid over an arbitrarily long maze,
+     * only available for the row-major layout.
+     */
+    void shiftRowsUp() {
+        const size_t rowWords = stride_ / 64;
+        for (auto* bits : {&openRight_, &openDown_, &visited_}) {
+            std::copy(bits->begin() + rowWords, bits->end(), bits->begin());
+            std::fill(bits->end() - rowWords, bits->end(), 0);
+        }
+    }
+
+    /**
+     * @brief Writes the bitplanes in binary form, see load().
+     */
+    void save(std::ostream& out) const {
+        for (const auto* bits : {&openRight_, &openDown_, &visited_}) {
+            out.write(reinterpret_cast<const char*>(bits->data()), bits->size() * sizeof(uint64_t));
+        }
+    }
+
+    /**
+     * @brief Restores the bitplanes written by save() from a grid with the
+     * same size and layout.
+     * @return false if the data is truncated.
+     */
+    bool load(std::istream& in) {
+        for (auto* bits : {&openRight_, &openDown_, &visited_}) {
+            if (!in.read(reinterpret_cast<char*>(bits->data()), bits->size() * sizeof(uint64_t))) return false;
+        }
+        return true;
+    }
+
+    bool isVisited(int x, int y) const { return testBit(visited_, bitIndex(x, y)); }
+    void markVisited(int x, int y) { setBit(visited_, bitIndex(x, y)); }
+
+private:
+    size_t wordCount() const {
+        if (layout_ == GridLayout::Morton) return tilesPerRow_ * ((static_cast<size_t>(height_) + 7) / 8);
+        return stride_ / 64 * static_cast<size_t>(height_);
+    }
+    size_t bitIndex(int x, int y) const {
+        if (layout_ == GridLayout::RowMajor) return static_cast<size_t>(y) * stride_ + x;
+        // 8x8 tile, then the interleaved bits y2 x2 y1 x1 y0 x0 inside it
+        size_t tile = static_cast<size_t>(y >> 3) * tilesPerRow_ + (x >> 3);
+        unsigned z = (x & 1) | ((y & 1) << 1) | ((x & 2) << 1) | ((y & 2) << 2) | ((x & 4) << 2) | ((y & 4) << 3);
+        return tile * 64 + z;
+    }
+
+    uint64_t rowWord(const WordBuffer& plane, int y, int x0) const {
+        if (layout_ == GridLayout::RowMajor) return plane[bitIndex(x0, y) >> 6];
+        uint64_t bits = 0;
+        const int n = std::min(64, width_ - x0);
+        for (int i = 0; i < n; ++i) bits |= static_cast<uint64_t>(testBit(plane, bitIndex(x0 + i, y))) << i;
+        return bits;
+    }
+
+    static bool testBit(const WordBuffer& bits, size_t i) {
+        return (bits[i >> 6] >> (i & 63)) & 1u;
+    }
+    static void setBit(WordBuffer& bits, size_t i) {
+        bits[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    int width_;
+    int height_;
+    GridLayout layout_;
+    size_t stride_; // bits per row (row-major)
+    size_t tilesPerRow_; // 8x8 tiles per tile row (Morton)
+    std::string storagePath_;
+    WordBuffer openRight_;
+    WordBuffer openDown_;
+    WordBuffer visited_;
+};
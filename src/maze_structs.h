@@ -1,23 +1,190 @@
 #pragma once
-#include <list>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 struct MazeCoordinate {
     float x;
     float y;
 };
 
+/**
+ * @brief Read-only view on a contiguous range of elements.
+ */
+template <class T>
+class ConstSpan {
+public:
+    ConstSpan() = default;
+    ConstSpan(const T* data, size_t size) : data_(data), size_(size) {}
+
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+using CoordinateSpan = ConstSpan<MazeCoordinate>;
+// offsets and node indices are 64 bit, grids can have more than 2^32 cells
+using IndexSpan = ConstSpan<uint64_t>;
+
+/**
+ * @brief A single polygon inside a PolygonStore.
+ */
 struct Mazepolygon {
-    std::list<MazeCoordinate> coordinates;
+    CoordinateSpan coordinates;
+};
+
+/**
+ * @brief Flat polygon storage.
+ *
+ * All coordinates live in one array, polygon i covers the range
+ * [offsets[i], offsets[i+1]) of it. Iterating the store yields Mazepolygon
+ * views, which stay valid until the store is modified.
+ */
+class PolygonStore {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const PolygonStore* store, size_t index) : store_(store), index_(index) {}
+        Mazepolygon operator*() const { return (*store_)[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const PolygonStore* store_;
+        size_t index_;
+    };
+
+    PolygonStore() : offsets_(1, 0) {}
+
+    size_t size() const { return offsets_.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    Mazepolygon operator[](size_t i) const {
+        return Mazepolygon{CoordinateSpan(coordinates_.data() + offsets_[i], offsets_[i + 1] - offsets_[i])};
+    }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    const std::vector<MazeCoordinate>& coordinates() const { return coordinates_; }
+    const std::vector<uint64_t>& offsets() const { return offsets_; }
+
+    void reserve(size_t polygonCount, size_t coordinateCount) {
+        offsets_.reserve(polygonCount + 1);
+        coordinates_.reserve(coordinateCount);
+    }
+
+    void clear() {
+        coordinates_.clear();
+        offsets_.assign(1, 0);
+    }
+
+    /**
+     * @brief Appends a polygon, the coordinates are copied into the store.
+     */
+    void addPolygon(const MazeCoordinate* coords, size_t count) {
+        coordinates_.insert(coordinates_.end(), coords, coords + count);
+        offsets_.push_back(coordinates_.size());
+    }
+
+    /**
+     * @brief Appends a polygon coordinate by coordinate, finish it with
+     * closePolygon().
+     */
+    void addCoordinate(MazeCoordinate coord) { coordinates_.push_back(coord); }
+    void closePolygon() { offsets_.push_back(coordinates_.size()); }
+
+    /**
+     * @brief Replaces the content with the given flat arrays, used by the
+     * generated loaders.
+     *
+     * @param coords All coordinates of all polygons.
+     * @param coordinateCount The number of coordinates.
+     * @param offsets polygonCount + 1 offsets into coords, starting with 0.
+     * @param polygonCount The number of polygons.
+     */
+    void assign(const MazeCoordinate* coords, size_t coordinateCount, const uint64_t* offsets, size_t polygonCount) {
+        coordinates_.assign(coords, coords + coordinateCount);
+        offsets_.assign(offsets, offsets + polygonCount + 1);
+    }
+
+private:
+    std::vector<MazeCoordinate> coordinates_;
+    std::vector<uint64_t> offsets_;
 };
 
-struct SolutionGraphNode {
-    MazeCoordinate coordinate;
-    std::list<SolutionGraphNode*> neighbors;
+/**
+ * @brief Solution graph in compressed sparse row form.
+ *
+ * Node i is located at coordinates()[i], its neighbours are the node indices
+ * neighborIndices()[offsets()[i] .. offsets()[i+1]). Nodes are appended in
+ * index order with addNode()/addNeighbor()/closeNode().
+ */
+class SolutionGraph {
+public:
+    SolutionGraph() : offsets_(1, 0) {}
+
+    size_t size() const { return coordinates_.size(); }
+    bool empty() const { return coordinates_.empty(); }
+
+    const MazeCoordinate& coordinate(size_t node) const { return coordinates_[node]; }
+    IndexSpan neighbors(size_t node) const {
+        return IndexSpan(neighbors_.data() + offsets_[node], offsets_[node + 1] - offsets_[node]);
+    }
+
+    const std::vector<MazeCoordinate>& coordinates() const { return coordinates_; }
+    const std::vector<uint64_t>& offsets() const { return offsets_; }
+    const std::vector<uint64_t>& neighborIndices() const { return neighbors_; }
+
+    void reserve(size_t nodeCount, size_t neighborCount) {
+        coordinates_.reserve(nodeCount);
+        offsets_.reserve(nodeCount + 1);
+        neighbors_.reserve(neighborCount);
+    }
+
+    void clear() {
+        coordinates_.clear();
+        offsets_.assign(1, 0);
+        neighbors_.clear();
+    }
+
+    void addNode(MazeCoordinate coord) { coordinates_.push_back(coord); }
+    void addNeighbor(uint64_t node) { neighbors_.push_back(node); }
+    void closeNode() { offsets_.push_back(neighbors_.size()); }
+
+    /**
+     * @brief Replaces the content with the given flat arrays, used by the
+     * generated loaders.
+     *
+     * @param coords The node coordinates.
+     * @param nodeCount The number of nodes.
+     * @param offsets nodeCount + 1 offsets into neighbors, starting with 0.
+     * @param neighbors The neighbour indices of all nodes.
+     * @param neighborCount The number of entries in neighbors.
+     */
+    void assign(const MazeCoordinate* coords, size_t nodeCount, const uint64_t* offsets,
+                const uint64_t* neighbors, size_t neighborCount) {
+        coordinates_.assign(coords, coords + nodeCount);
+        offsets_.assign(offsets, offsets + nodeCount + 1);
+        neighbors_.assign(neighbors, neighbors + neighborCount);
+    }
+
+private:
+    std::vector<MazeCoordinate> coordinates_;
+    std::vector<uint64_t> offsets_;
+    std::vector<uint64_t> neighbors_;
 };
 
 class MazeGenerator {
 public:
-    std::list<Mazepolygon> polygons; // List of polygons that form the maze
-    std::list<SolutionGraphNode> solutionGraph; // Graph representing the solution path through the maze
+    PolygonStore polygons; // Polygons that form the maze
+    SolutionGraph solutionGraph; // Graph representing the solution path through the maze
     void generateMaze();
-}; 
\ No newline at end of file
+};
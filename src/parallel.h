@@ -0,0 +1,28 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Splits [0, count) into contiguous ranges and runs f(begin, end) for
+ * each of them on its own thread. With threads <= 1 f runs on the calling
+ * thread. Results must not depend on the split, callers derive their random
+ * streams from the item index, never from the thread.
+ */
+template <class F>
+void parallelFor(size_t count, unsigned threads, F f) {
+    size_t workers = std::min<size_t>(std::max(threads, 1u), count);
+    if (workers <= 1) {
+        f(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (size_t w = 0; w < workers; ++w) {
+        size_t begin = count * w / workers;
+        size_t end = count * (w + 1) / workers;
+        pool.emplace_back([=, &f] { f(begin, end); });
+    }
+    for (auto& t : pool) t.join();
+}
@@ -0,0 +1,295 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Random number engines for the maze generation.
+ *
+ * All engines produce 64 bit values through operator() and are sampled
+ * with the portable helpers below instead of the std distributions, whose
+ * results differ between standard libraries. The same seed therefore gives
+ * the same maze on GCC and Clang builds.
+ */
+
+/**
+ * @brief SplitMix64, also used to expand seeds for the other engines.
+ */
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed) : state_(seed) {}
+
+    uint64_t operator()() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state_;
+};
+
+/**
+ * @brief xoshiro256** by Blackman and Vigna.
+ */
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(uint64_t seed) {
+        SplitMix64 sm(seed);
+        for (auto& s : s_) s = sm();
+    }
+
+    uint64_t operator()() {
+        const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+        const uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 45);
+        return result;
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    uint64_t s_[4];
+};
+
+/**
+ * @brief PCG64 (XSL RR 128/64) by O'Neill.
+ */
+class Pcg64 {
+public:
+    explicit Pcg64(uint64_t seed) {
+        SplitMix64 sm(seed);
+        uint64_t s0 = sm(), s1 = sm(), i0 = sm(), i1 = sm();
+        inc_ = ((static_cast<unsigned __int128>(i0) << 64) | i1) | 1u;
+        state_ = 0;
+        step();
+        state_ += (static_cast<unsigned __int128>(s0) << 64) | s1;
+        step();
+    }
+
+    uint64_t operator()() {
+        step();
+        uint64_t xored = static_cast<uint64_t>(state_ >> 64) ^ static_cast<uint64_t>(state_);
+        unsigned rot = static_cast<unsigned>(state_ >> 122);
+        return (xored >> rot) | (xored << ((64 - rot) & 63));
+    }
+
+private:
+    void step() {
+        const unsigned __int128 mult =
+            (static_cast<unsigned __int128>(0x2360ed051fc65da4ull) << 64) | 0x4385df649fccf645ull;
+        state_ = state_ * mult + inc_;
+    }
+    unsigned __int128 state_;
+    unsigned __int128 inc_;
+};
+
+/**
+ * @brief The 32 bit Mersenne Twister combined to 64 bit outputs. Its seeding
+ * and output sequence are fixed by the standard, so it is portable as long
+ * as it is only sampled through the helpers below.
+ */
+class Mt19937 {
+public:
+    explicit Mt19937(uint64_t seed) : engine_(static_cast<std::mt19937::result_type>(seed)) {}
+
+    uint64_t operator()() {
+        uint64_t hi = engine_();
+        return (hi << 32) | engine_();
+    }
+
+private:
+    std::mt19937 engine_;
+};
+
+/**
+ * @brief Counter-based random value, the SplitMix64 output for position
+ * counter of the sequence starting at seed. Any value of a stream can be
+ * computed independently, which keeps parallel stages reproducible.
+ */
+inline uint64_t hashRandom(uint64_t seed, uint64_t counter) {
+    uint64_t z = seed + (counter + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// independent random streams derived from the user seed
+enum RandomStream : uint64_t {
+    STREAM_GENERATION = 1,
+    STREAM_CROSSINGS = 2,
+    STREAM_CHUNKS = 3,
+    STREAM_CHUNK_BORDERS = 4,
+    STREAM_VARIANTS = 5,
+};
+
+/**
+ * @brief Derives the seed of a sub stream (stage, region, row, ...) from the
+ * user seed.
+ *
+ * @param seed The 64 bit user seed.
+ * @param stream The stream id, e.g. a RandomStream.
+ * @param index Index inside the stream, e.g. the region number.
+ */
+inline uint64_t streamSeed(uint64_t seed, uint64_t stream, uint64_t index = 0) {
+    return hashRandom(hashRandom(seed, stream), index);
+}
+
+/**
+ * @brief Unbiased integer in [0, bound) using Lemire's multiply-shift method.
+ */
+template <class Rng>
+uint32_t uniformInt(Rng& rng, uint32_t bound) {
+    uint64_t m = static_cast<uint64_t>(static_cast<uint32_t>(rng() >> 32)) * bound;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = static_cast<uint64_t>(static_cast<uint32_t>(rng() >> 32)) * bound;
+            low = static_cast<uint32_t>(m);
+        }
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
+
+/**
+ * @brief Unbiased integer in [0, bound) for bounds beyond 32 bit, same
+ * method on the full 64 bit draw.
+ */
+template <class Rng>
+uint64_t uniformInt64(Rng& rng, uint64_t bound) {
+    unsigned __int128 m = static_cast<unsigned __int128>(static_cast<uint64_t>(rng())) * bound;
+    uint64_t low = static_cast<uint64_t>(m);
+    if (low < bound) {
+        uint64_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = static_cast<unsigned __int128>(static_cast<uint64_t>(rng())) * bound;
+            low = static_cast<uint64_t>(m);
+        }
+    }
+    return static_cast<uint64_t>(m >> 64);
+}
+
+/**
+ * @brief Float in [0, 1) built from the upper 24 bits of one draw.
+ */
+template <class Rng>
+float uniformFloat(Rng& rng) {
+    return static_cast<float>(rng() >> 40) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Fisher-Yates shuffle drawing through uniformInt, positions past
+ * 2^32 draw through uniformInt64.
+ */
+template <class Rng, class It>
+void shuffleRange(It first, It last, Rng& rng) {
+    auto n = last - first;
+    for (; n > static_cast<decltype(n)>(UINT32_MAX); --n) {
+        auto j = uniformInt64(rng, static_cast<uint64_t>(n));
+        std::swap(first[n - 1], first[j]);
+    }
+    for (; n > 1; --n) {
+        auto j = uniformInt(rng, static_cast<uint32_t>(n));
+        std::swap(first[n - 1], first[j]);
+    }
+}
+
+/**
+ * @brief Walker's alias method: draws index i with probability
+ * weights[i] / sum(weights) from a single random value in constant time.
+ *
+ * The table is built with Vose's algorithm in O(n). The upper 32 bits of
+ * the random value pick a column, the lower 32 bits decide between the
+ * column and its alias.
+ */
+class AliasTable {
+public:
+    AliasTable() = default;
+
+    /**
+     * @param weights Non-negative weights, all zero is treated as all equal.
+     */
+    explicit AliasTable(const std::vector<double>& weights) : columns_(weights.size()) {
+        const size_t n = weights.size();
+        double total = 0;
+        for (double w : weights) total += w;
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (size_t i = 0; i < n; ++i) {
+            scaled[i] = total > 0 ? weights[i] * n / total : 1.0;
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+        while (!small.empty() && !large.empty()) {
+            const uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            columns_[s] = Column{static_cast<uint64_t>(scaled[s] * 4294967296.0), l};
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // the rest is 1 up to rounding errors
+        for (uint32_t i : large) columns_[i] = Column{uint64_t(1) << 32, i};
+        for (uint32_t i : small) columns_[i] = Column{uint64_t(1) << 32, i};
+    }
+
+    size_t size() const { return columns_.size(); }
+
+    /**
+     * @brief The index drawn by a 64 bit random value, e.g. from hashRandom().
+     */
+    uint32_t sample(uint64_t random) const {
+        const uint32_t i = static_cast<uint32_t>(((random >> 32) * columns_.size()) >> 32);
+        return (random & 0xffffffffu) < columns_[i].threshold ? i : columns_[i].alias;
+    }
+
+    template <class Rng>
+    uint32_t operator()(Rng& rng) const {
+        return sample(rng());
+    }
+
+private:
+    // the column keeps its own index with probability threshold / 2^32
+    struct Column {
+        uint64_t threshold;
+        uint32_t alias;
+    };
+    std::vector<Column> columns_;
+};
+
+/**
+ * @brief Constructs the engine with the given name and passes it to f.
+ *
+ * @param name mt19937, xoshiro256, pcg64 or splitmix.
+ * @param seed The seed for the engine.
+ * @param f Callable taking the engine by reference.
+ * @return false if the name is unknown.
+ */
+template <class F>
+bool withRngEngine(const std::string& name, uint64_t seed, F&& f) {
+    if (name == "mt19937") {
+        Mt19937 rng(seed);
+        f(rng);
+    } else if (name == "xoshiro256" || name == "xoshiro256**") {
+        Xoshiro256 rng(seed);
+        f(rng);
+    } else if (name == "pcg64") {
+        Pcg64 rng(seed);
+        f(rng);
+    } else if (name == "splitmix") {
+        SplitMix64 rng(seed);
+        f(rng);
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "maze_grid.h"
+
+/**
+ * @brief Gray image read from a PGM file.
+ * @var pixels: row by row, values 0 .. maxValue
+ */
+struct PgmImage {
+    int width = 0;
+    int height = 0;
+    int maxValue = 255;
+    std::vector<uint16_t> pixels;
+};
+
+/**
+ * @brief Reads a plain (P2) or binary (P5) PGM image, 8 or 16 bit.
+ * @return false if the file cannot be read or is not a valid PGM image.
+ */
+inline bool loadPgm(const std::string& path, PgmImage& image) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    // header tokens, comments run from # to the end of the line
+    auto readNumber = [&in](int& value) {
+        for (int c = in.peek(); c != EOF && (std::isspace(c) || c == '#'); c = in.peek()) {
+            if (c == '#') in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            else in.get();
+        }
+        return static_cast<bool>(in >> value);
+    };
+    std::string magic;
+    if (!(in >> magic) || (magic != "P2" && magic != "P5")) return false;
+    if (!readNumber(image.width) || !readNumber(image.height) || !readNumber(image.maxValue)) return false;
+    if (image.width <= 0 || image.height <= 0 || image.maxValue <= 0 || image.maxValue > 65535) return false;
+    image.pixels.resize(static_cast<size_t>(image.width) * image.height);
+    if (magic == "P2") {
+        for (auto& p : image.pixels) {
+            int value;
+            if (!readNumber(value)) return false;
+            p = static_cast<uint16_t>(std::min(std::max(value, 0), image.maxValue));
+        }
+        return true;
+    }
+    in.get(); // single whitespace after the header
+    const size_t bytes = image.maxValue > 255 ? 2 : 1;
+    std::vector<unsigned char> raw(image.pixels.size() * bytes);
+    if (!in.read(reinterpret_cast<char*>(raw.data()), raw.size())) return false;
+    for (size_t i = 0; i < image.pixels.size(); ++i) {
+        image.pixels[i] = bytes == 2 ? static_cast<uint16_t>(raw[2 * i] << 8 | raw[2 * i + 1]) : raw[i];
+    }
+    return true;
+}
+
+/**
+ * @brief The cells of the grid that belong to the track, one bit per cell.
+ *
+ * Light pixels (more than half of the maximum gray value) are free cells,
+ * dark pixels are blocked. The image is scaled to the grid by nearest
+ * neighbour. Besides the free cells the mask keeps the interior cells, the
+ * free cells whose four neighbours are free too: only they may become
+ * crossings, so a crossing never opens a wall into a blocked cell.
+ *
+ * Rows are padded to whole 64 bit words like the row-major MazeGrid, bit
+ * x % 64 of word x / 64 stands for cell x.
+ */
+class ShapeMask {
+public:
+    ShapeMask(const PgmImage& image, int width, int height)
+        : width_(width), height_(height), wordsPerRow_((static_cast<size_t>(width) + 63) / 64),
+          free_(wordsPerRow_ * height, 0), interior_(wordsPerRow_ * height, 0) {
+        const int threshold = image.maxValue / 2;
+        for (int y = 0; y < height; ++y) {
+            const uint16_t* src = image.pixels.data() + static_cast<size_t>(y) * image.height / height * image.width;
+            uint64_t* row = free_.data() + wordsPerRow_ * y;
+            for (int x = 0; x < width; ++x) {
+                if (src[static_cast<size_t>(x) * image.width / width] > threshold) row[x >> 6] |= uint64_t(1) << (x & 63);
+            }
+        }
+        for (int y = 1; y + 1 < height; ++y) {
+            const uint64_t* above = freeRow(y - 1);
+            const uint64_t* row = freeRow(y);
+            const uint64_t* below = freeRow(y + 1);
+            uint64_t* interior = interior_.data() + wordsPerRow_ * y;
+            for (size_t w = 0; w < wordsPerRow_; ++w) {
+                const uint64_t left = (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+                const uint64_t right = (row[w] >> 1) | (w + 1 < wordsPerRow_ ? row[w + 1] << 63 : 0);
+                interior[w] = row[w] & above[w] & below[w] & left & right;
+            }
+        }
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    bool isFree(int x, int y) const { return (freeRow(y)[x >> 6] >> (x & 63)) & 1u; }
+    const uint64_t* freeRow(int y) const { return free_.data() + wordsPerRow_ * y; }
+    const uint64_t* interiorRow(int y) const { return interior_.data() + wordsPerRow_ * y; }
+
+    size_t freeCount() const {
+        size_t count = 0;
+        for (uint64_t w : free_) count += __builtin_popcountll(w);
+        return count;
+    }
+
+    /**
+     * @brief Marks the blocked cells of the maze as visited, so the
+     * generator never enters them and they keep all four walls.
+     */
+    void blockCells(MazeGrid& maze) const {
+        const uint64_t lastMask = (width_ & 63) ? (uint64_t(1) << (width_ & 63)) - 1 : ~uint64_t(0);
+        for (int y = 0; y < height_; ++y) {
+            for (size_t w = 0; w < wordsPerRow_; ++w) {
+                uint64_t blocked = ~freeRow(y)[w] & (w + 1 == wordsPerRow_ ? lastMask : ~uint64_t(0));
+                while (blocked) {
+                    maze.markVisited(static_cast<int>(w * 64 + __builtin_ctzll(blocked)), y);
+                    blocked &= blocked - 1;
+                }
+            }
+        }
+    }
+
+private:
+    int width_;
+    int height_;
+    size_t wordsPerRow_;
+    std::vector<uint64_t> free_;
+    std::vector<uint64_t> interior_;
+};
@@ -0,0 +1,46 @@
+#!/bin/sh
+# Determinism test: generates the same mazes with 1, 4 and 32 threads and
+# compares the --hash output and the generated files, for both layouts.
+#
+# usage (from the src directory): tests/determinism.sh [trackgen binary]
+# Without a binary, trackgen is built into a temporary directory first.
+set -e
+cd "$(dirname "$0")/.."
+src=$(pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+trackgen=${1:-}
+if [ -z "$trackgen" ]; then
+    trackgen="$work/trackgen"
+    g++ -std=c++17 -O2 -pthread main.cpp -o "$trackgen"
+fi
+case "$trackgen" in /*) ;; *) trackgen="$src/$trackgen" ;; esac
+
+seed=0x9e3779b97f4a7c15
+failed=0
+for layout in row-major morton; do
+    for algorithm in dfs parallel-dfs; do
+        reference=""
+        for threads in 1 4 32; do
+            run="$work/$layout-$algorithm-$threads"
+            mkdir -p "$run"
+            hash=$(cd "$run" && "$trackgen" "$src/tileset.json" track.cpp 200 0.2 "$seed" --algorithm "$algorithm" \
+                       --region-size 64 --layout "$layout" --threads "$threads" --hash | grep Maze-Hash)
+            files=$(cd "$run" && cat track.cpp track.svg | cksum)
+            echo "$layout $algorithm threads=$threads: $hash"
+            if [ -z "$reference" ]; then
+                reference="$hash $files"
+            elif [ "$reference" != "$hash $files" ]; then
+                echo "  differs from threads=1"
+                failed=1
+            fi
+        done
+    done
+done
+
+if [ "$failed" -ne 0 ]; then
+    echo "FAILED: the output depends on the thread count"
+    exit 1
+fi
+echo "ok: identical output for 1, 4 and 32 threads"
@@ -0,0 +1,476 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include "json.hpp"
+#include "random.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// upper limit for the number of rotated tiles, the width of a TileMask
+#ifndef TILESET_MAX_TILES
+#define TILESET_MAX_TILES 512
+#endif
+
+/**
+ * @brief Fixed-width bitset over tile indices.
+ */
+struct TileMask {
+    static constexpr size_t WORDS = (TILESET_MAX_TILES + 63) / 64;
+    std::array<uint64_t, WORDS> words{};
+
+    void set(size_t i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset(size_t i) { words[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    bool test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1u; }
+
+    bool any() const {
+        for (uint64_t w : words) if (w) return true;
+        return false;
+    }
+    size_t count() const {
+        size_t n = 0;
+        for (uint64_t w : words) n += __builtin_popcountll(w);
+        return n;
+    }
+
+    /**
+     * @brief True if both masks share a tile. Branch free, so the loop is
+     * compiled to vector instructions.
+     */
+    bool intersects(const TileMask& other) const {
+        uint64_t common = 0;
+        for (size_t i = 0; i < WORDS; ++i) common |= words[i] & other.words[i];
+        return common != 0;
+    }
+
+    /**
+     * @brief Index of the n-th set bit (counting from 0) in ascending order,
+     * -1 if fewer bits are set.
+     */
+    int nth(size_t n) const {
+        for (size_t w = 0; w < WORDS; ++w) {
+            uint64_t bits = words[w];
+            const size_t count = __builtin_popcountll(bits);
+            if (n >= count) {
+                n -= count;
+                continue;
+            }
+            for (; n > 0; --n) bits &= bits - 1;
+            return static_cast<int>(w * 64 + __builtin_ctzll(bits));
+        }
+        return -1;
+    }
+
+    TileMask& operator&=(const TileMask& other) {
+        for (size_t i = 0; i < WORDS; ++i) words[i] &= other.words[i];
+        return *this;
+    }
+    TileMask& operator|=(const TileMask& other) {
+        for (size_t i = 0; i < WORDS; ++i) words[i] |= other.words[i];
+        return *this;
+    }
+    TileMask& operator^=(const TileMask& other) {
+        for (size_t i = 0; i < WORDS; ++i) words[i] ^= other.words[i];
+        return *this;
+    }
+    friend TileMask operator&(TileMask a, const TileMask& b) { return a &= b; }
+    friend TileMask operator^(TileMask a, const TileMask& b) { return a ^= b; }
+    friend TileMask operator|(TileMask a, const TileMask& b) { return a |= b; }
+    bool operator==(const TileMask& other) const { return words == other.words; }
+    bool operator!=(const TileMask& other) const { return words != other.words; }
+
+    /**
+     * @brief Calls f(index) for every set bit in ascending order.
+     */
+    template <class F>
+    void forEach(F f) const {
+        for (size_t w = 0; w < WORDS; ++w) {
+            uint64_t bits = words[w];
+            while (bits) {
+                f(w * 64 + __builtin_ctzll(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+};
+
+/**
+ * @brief representation of a tile
+ * @var edges: open (O)/closed (X) connections on the tile edges
+ * @var edgeIds: interned edge labels, index into Tileset::edgeLabels
+ * @var validNeighbors: per direction the tiles that may be placed next to this tile
+ * @var weight: relative frequency among the tiles that fit the same place
+ */
+struct Tile {
+    std::string name;
+    std::vector<std::vector<std::pair<float, float>>> walls;
+    std::vector<std::array<std::string, 4>> edges;
+    std::array<int, 4> edgeIds{};
+    int index = -1;
+    std::array<TileMask, 4> validNeighbors;
+    double weight = 1.0;
+};
+
+/**
+ * @brief A tile covering width x height cells, e.g. a long straight or a roundabout.
+ * @var walls: wall polygons in tile coordinates [0, width] x [0, height]
+ * @var cellEdgeIds: interned edge labels of every cell, row-major
+ */
+struct MacroTile {
+    std::string name;
+    int width = 1;
+    int height = 1;
+    std::vector<std::vector<std::pair<float, float>>> walls;
+    std::vector<std::array<int, 4>> cellEdgeIds;
+};
+
+/**
+ * @brief All rotated tiles of a tileset together with the interned edge labels.
+ * @var tilesWithEdge: [dir][label] the tiles whose edge in direction dir has the label
+ * @var tileWeights: draws a tile index by the tile weights
+ * @var uniformWeights: all tiles have the same weight
+ * @var macros: all rotations of the tiles spanning several cells
+ */
+struct Tileset {
+    std::vector<Tile> tiles;
+    std::vector<MacroTile> macros;
+    std::vector<std::string> edgeLabels;
+    std::array<std::vector<TileMask>, 4> tilesWithEdge;
+    AliasTable tileWeights;
+    bool uniformWeights = true;
+
+    /**
+     * @brief Returns the id of an edge label, or -1 if no tile uses it.
+     */
+    int edgeId(const std::string& label) const {
+        for (size_t i = 0; i < edgeLabels.size(); ++i) {
+            if (edgeLabels[i] == label) return static_cast<int>(i);
+        }
+        return -1;
+    }
+};
+
+/**
+ * @brief Rotates the walls of a tile so the
+ * wall positions are updated according to the rotation.
+ *
+ * @param walls The original wall positions.
+ * @param rot The rotation angle in 90-degree increments (0-3).
+ */
+inline std::vector<std::vector<std::pair<float, float>>> rotateWalls(
+    const std::vector<std::vector<std::pair<float, float>>>& walls, int rot) {
+    std::vector<std::vector<std::pair<float, float>>> result = walls;
+    float angle = rot * (M_PI / 2.0f);
+    float cos_a = std::cos(angle);
+    float sin_a = std::sin(angle);
+    for (auto& wall : result) {
+        for (auto& p : wall) {
+            float x = p.first - 0.5f;
+            float y = p.second - 0.5f;
+            float x_new = cos_a * x - sin_a * y;
+            float y_new = sin_a * x + cos_a * y;
+            p.first = x_new + 0.5f;
+            p.second = y_new + 0.5f;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Transforms a set of 2D coordinates by applying translation and rotation.
+ *
+ * @param coords The coordinates to transform.
+ * @param dx The translation in the x direction.
+ * @param dy The translation in the y direction.
+ * @param angle_rad The rotation angle in radians.
+ * @return The transformed coordinates.
+ */
+inline std::vector<std::pair<float, float>> transform(const std::vector<std::pair<float, float>>& coords, float dx, float dy, float angle_rad) {
+    std::vector<std::pair<float, float>> result;
+    float cos_a = std::cos(angle_rad);
+    float sin_a = std::sin(angle_rad);
+    for (const auto& [x, y] : coords) {
+        float x_new = cos_a * x - sin_a * y + dx;
+        float y_new = sin_a * x + cos_a * y + dy;
+        result.emplace_back(x_new, y_new);
+    }
+    return result;
+}
+
+/**
+ * @brief Rotates a macro tile by 90 degrees in the same sense as rotateWalls,
+ * the edge in direction d becomes the edge in direction d + 1.
+ */
+inline MacroTile rotateMacroTile(const MacroTile& macro) {
+    MacroTile result = macro;
+    result.width = macro.height;
+    result.height = macro.width;
+    for (int cy = 0; cy < macro.height; ++cy) {
+        for (int cx = 0; cx < macro.width; ++cx) {
+            const auto& ids = macro.cellEdgeIds[cy * macro.width + cx];
+            auto& rotated = result.cellEdgeIds[cx * result.width + (macro.height - 1 - cy)];
+            for (int d = 0; d < 4; ++d) rotated[(d + 1) % 4] = ids[d];
+        }
+    }
+    for (auto& wall : result.walls) {
+        for (auto& p : wall) p = {macro.height - p.second, p.first};
+    }
+    return result;
+}
+
+/**
+ * @brief Loads a tileset from a JSON file and generates all rotations.
+ *
+ * Edge labels are interned to small integer ids. Two edges match if they
+ * carry the same label, so compatible neighbours are looked up through the
+ * tiles bucketed by label instead of comparing every pair of tiles. Rotations
+ * of a tile with the same edge signature as an earlier rotation (e.g. cross,
+ * block) are dropped.
+ *
+ * The optional "weight" of a tile (default 1) times the optional entry of
+ * "rotation_weights" (one per edges entry, default 1) is the weight of a
+ * rotation; rotations with weight 0 are left out.
+ *
+ * Entries with a "size" [width, height] are macro tiles: "cells" lists the
+ * edge labels of every cell row by row, edges between two cells of the tile
+ * have to carry the same label on both sides, and the walls are given in
+ * tile coordinates. Their rotations are derived from the first orientation.
+ *
+ * @param filename The path to the JSON file.
+ * @return Tileset All tiles with their rotations, empty if loading failed.
+ */
+inline Tileset loadTilesetWithEdges(const std::string& filename) {
+    std::ifstream file(filename);
+    nlohmann::json j;
+    file >> j;
+    Tileset tileset;
+    std::unordered_map<std::string, int> labelIds;
+    auto intern = [&](const std::string& label) {
+        auto it = labelIds.find(label);
+        if (it != labelIds.end()) return it->second;
+        int id = static_cast<int>(tileset.edgeLabels.size());
+        labelIds.emplace(label, id);
+        tileset.edgeLabels.push_back(label);
+        return id;
+    };
+    std::vector<Tile> baseTiles;
+    std::vector<std::vector<double>> baseWeights;
+    int idx = 0;
+    const float padding = 0.0025f; // 5% padding on each side
+    for (const auto& t : j) {
+        if (t.contains("size")) {
+            MacroTile macro;
+            macro.name = t["name"];
+            macro.width = t["size"][0];
+            macro.height = t["size"][1];
+            const auto& cells = t["cells"];
+            bool valid = macro.width >= 1 && macro.width <= 8 && macro.height >= 1 && macro.height <= 8 &&
+                         cells.size() == static_cast<size_t>(macro.width * macro.height);
+            for (size_t c = 0; valid && c < cells.size(); ++c) {
+                std::array<int, 4> ids;
+                for (int d = 0; d < 4; ++d) ids[d] = intern(cells[c][d]);
+                macro.cellEdgeIds.push_back(ids);
+            }
+            for (int c = 0; valid && c < macro.width * macro.height; ++c) {
+                const auto& ids = macro.cellEdgeIds[c];
+                if (c % macro.width + 1 < macro.width && ids[0] != macro.cellEdgeIds[c + 1][2]) valid = false;
+                if (c / macro.width + 1 < macro.height && ids[1] != macro.cellEdgeIds[c + macro.width][3]) valid = false;
+            }
+            if (!valid) {
+                std::cerr << "Invalid macro tile: " << macro.name
+                          << " (size up to 8x8, one edge signature per cell, matching inner edges)" << std::endl;
+                return Tileset{};
+            }
+            const float w = macro.width, h = macro.height;
+            for (const auto& wall : t["walls"]) {
+                std::vector<std::pair<float, float>> wall_coords;
+                for (const auto& coord : wall) {
+                    float x = coord[0];
+                    float y = coord[1];
+                    wall_coords.emplace_back(w / 2 + (x - w / 2) * (1.0f - 2.0f * padding / w),
+                                             h / 2 + (y - h / 2) * (1.0f - 2.0f * padding / h));
+                }
+                macro.walls.push_back(wall_coords);
+            }
+            const std::string base = macro.name;
+            for (int rot = 0; rot < 4; ++rot, macro = rotateMacroTile(macro)) {
+                bool duplicate = false;
+                for (const auto& m : tileset.macros) {
+                    duplicate = duplicate || (m.name.rfind(base + "_rot", 0) == 0 && m.width == macro.width &&
+                                              m.cellEdgeIds == macro.cellEdgeIds);
+                }
+                if (duplicate) continue;
+                MacroTile rotated = macro;
+                rotated.name = base + "_rot" + std::to_string(rot * 90);
+                tileset.macros.push_back(rotated);
+            }
+            continue;
+        }
+        Tile tile;
+        tile.name = t["name"];
+        for (const auto& wall : t["walls"]) {
+            std::vector<std::pair<float, float>> wall_coords;
+            for (const auto& coord : wall) {
+                // Move each coordinate towards the center (0.5, 0.5)
+                float x = coord[0];
+                float y = coord[1];
+                float x_padded = 0.5f + (x - 0.5f) * (1.0f - 2.0f * padding);
+                float y_padded = 0.5f + (y - 0.5f) * (1.0f - 2.0f * padding);
+                wall_coords.emplace_back(x_padded, y_padded);
+            }
+            tile.walls.push_back(wall_coords);
+        }
+        if (t.contains("edges")) {
+            for (const auto& e : t["edges"]) {
+                std::array<std::string, 4> arr;
+                for (int i = 0; i < 4; ++i) arr[i] = e[i];
+                tile.edges.push_back(arr);
+            }
+        } else {
+            std::cerr << "Missing edge definitions for tile: " << tile.name << std::endl;
+            tile.edges.push_back({"X", "X", "X", "X"});
+        }
+        tile.weight = t.value("weight", 1.0);
+        std::vector<double> rotationWeights = t.value("rotation_weights", std::vector<double>(tile.edges.size(), 1.0));
+        bool negative = tile.weight < 0;
+        for (double w : rotationWeights) negative = negative || w < 0;
+        if (negative || rotationWeights.size() != tile.edges.size()) {
+            std::cerr << "Invalid weights for tile: " << tile.name
+                      << " (not negative, one rotation weight per edges entry)" << std::endl;
+            return Tileset{};
+        }
+        baseWeights.push_back(rotationWeights);
+        tile.index = idx++;
+        baseTiles.push_back(tile);
+    }
+    // generate all rotations and filter duplicates
+    auto& allTiles = tileset.tiles;
+    for (const auto& tile : baseTiles) {
+        std::vector<std::array<int, 4>> signatures;
+        for (int i = 0; i < tile.edges.size(); ++i) {
+            std::array<int, 4> ids;
+            for (int d = 0; d < 4; ++d) ids[d] = intern(tile.edges[i][d]);
+            bool duplicate = false;
+            for (const auto& s : signatures) duplicate = duplicate || s == ids;
+            if (duplicate) continue;
+            signatures.push_back(ids);
+            const double weight = tile.weight * baseWeights[tile.index][i];
+            if (weight == 0) continue;
+            if (allTiles.size() == TILESET_MAX_TILES) {
+                std::cerr << "Tileset has more than " << TILESET_MAX_TILES
+                          << " rotated tiles, rebuild with a larger TILESET_MAX_TILES" << std::endl;
+                return Tileset{};
+            }
+            Tile t = tile;
+            t.edges.clear();
+            t.edges.push_back(tile.edges[i]);
+            t.edgeIds = ids;
+            int extra_rot = 0;
+            if (tile.name.find("curve") != std::string::npos) extra_rot = 1;
+            if (tile.name.find("endcap") != std::string::npos) extra_rot = 2;
+            t.walls = rotateWalls(tile.walls, (i + extra_rot) % 4);
+            t.name = tile.name + "_rot" + std::to_string(i*90);
+            t.index = allTiles.size();
+            t.weight = weight;
+            allTiles.push_back(t);
+        }
+    }
+    std::vector<double> weights;
+    for (const auto& t : allTiles) {
+        weights.push_back(t.weight);
+        tileset.uniformWeights = tileset.uniformWeights && t.weight == allTiles[0].weight;
+    }
+    tileset.tileWeights = AliasTable(weights);
+    // bucket tiles by edge label per direction
+    for (int dir = 0; dir < 4; ++dir) {
+        tileset.tilesWithEdge[dir].assign(tileset.edgeLabels.size(), TileMask{});
+        for (const auto& t : allTiles) tileset.tilesWithEdge[dir][t.edgeIds[dir]].set(t.index);
+    }
+    // calculate adjacency for each tile: the neighbour in direction dir needs
+    // the same label on its opposite edge
+    for (auto& t : allTiles) {
+        for (int dir = 0; dir < 4; ++dir) {
+            t.validNeighbors[dir] = tileset.tilesWithEdge[(dir+2)%4][t.edgeIds[dir]];
+        }
+    }
+    return tileset;
+}
+
+/**
+ * @brief Lookup table from the closed walls of a cell to a tile index.
+ *
+ * The key is the wall bitmask of the cell (bit d = wall in direction d), so
+ * assigning a tile is a single indexed load. Combinations without a matching
+ * tile map to the block tile. If several tiles match a mask, variant()
+ * draws one of them by weight from a per-mask alias table.
+ */
+struct TileLookup {
+    std::array<int, 16> tileForMask;
+    std::array<std::vector<int>, 16> variants;
+    std::array<AliasTable, 16> variantWeights;
+    int blockTile = -1;
+    int operator[](unsigned walls) const { return tileForMask[walls]; }
+
+    /**
+     * @brief A tile for the walls, drawn by weight among the matching tiles.
+     * @param random 64 bit random value, e.g. hashRandom() of the cell.
+     */
+    int variant(unsigned walls, uint64_t random) const {
+        const std::vector<int>& tiles = variants[walls];
+        if (tiles.size() < 2) return tileForMask[walls];
+        return tiles[variantWeights[walls].sample(random)];
+    }
+};
+
+/**
+ * @brief Compiles the tileset into a TileLookup.
+ *
+ * Only tiles with open (O)/closed (X) edges can be expressed by a wall
+ * bitmask, tiles using other edge labels are ignored. If several tiles match
+ * the same mask the first one is returned by operator[], and variant()
+ * chooses between all of them by their weights.
+ *
+ * @param tileset The loaded tileset.
+ * @return The lookup table for all 16 wall combinations.
+ */
+inline TileLookup buildTileLookup(const Tileset& tileset) {
+    TileLookup lookup;
+    lookup.tileForMask.fill(-1);
+    const int open = tileset.edgeId("O");
+    const int closed = tileset.edgeId("X");
+    for (const Tile& tile : tileset.tiles) {
+        if (lookup.blockTile < 0 && tile.name.find("block") != std::string::npos) {
+            lookup.blockTile = tile.index;
+        }
+        unsigned walls = 0;
+        bool binary = true;
+        for (int d = 0; d < 4; ++d) {
+            if (tile.edgeIds[d] == closed) walls |= 1u << d;
+            else if (tile.edgeIds[d] != open) binary = false;
+        }
+        if (!binary) continue;
+        if (lookup.tileForMask[walls] < 0) lookup.tileForMask[walls] = tile.index;
+        lookup.variants[walls].push_back(tile.index);
+    }
+    for (unsigned walls = 0; walls < 16; ++walls) {
+        std::vector<double> weights;
+        for (int t : lookup.variants[walls]) weights.push_back(tileset.tiles[t].weight);
+        lookup.variantWeights[walls] = AliasTable(weights);
+    }
+    // missing combinations
+    for (unsigned walls = 0; walls < 16; ++walls) {
+        if (lookup.tileForMask[walls] >= 0) continue;
+        std::cerr << "Kein passendes Tile für Wände: ";
+        for (int d = 0; d < 4; ++d) std::cerr << ((walls & (1u << d)) ? "1" : "0");
+        std::cerr << ", verwende Blocktile" << std::endl;
+        lookup.tileForMask[walls] = lookup.blockTile;
+    }
+    return lookup;
+}
@@ -9,9 +9,10 @@ with open('tileset.json', 'r', encoding='utf-8') as f:
 
 os.makedirs('svg_tiles', exist_ok=True)
 
-def coord_to_svg(x, y):
-    # Scale 1x1 to SVG_SIZE x SVG_SIZE coordinates, invert y
-    return x * SVG_SIZE, SVG_SIZE - y * SVG_SIZE
+def coord_to_svg(x, y, cells=1):
+    # Scale cells x cells to SVG_SIZE x SVG_SIZE coordinates, invert y
+    scale = SVG_SIZE / cells
+    return x * scale, SVG_SIZE - y * scale
 
 def create_grid():
     grid = []
@@ -34,6 +35,8 @@ def create_grid():
 
 for tile in tiles:
     name = tile['name']
+    # macro tiles span several cells and are shrunk to fit
+    cells = max(tile.get('size', [1, 1]))
     
     # SVG header with empty background
     svg = f'''<?xml version="1.0" encoding="UTF-8" standalone="no"?>
@@ -51,7 +54,7 @@ for tile in tiles:
 
     # walls as closed polygons
     for wall in tile['walls']:
-        svg_coords = [coord_to_svg(x, y) for x, y in wall]
+        svg_coords = [coord_to_svg(x, y, cells) for x, y in wall]
         path = f"M {svg_coords[0][0]:.1f},{svg_coords[0][1]:.1f}"
         for x, y in svg_coords[1:]:
             path += f" L {x:.1f},{y:.1f}"
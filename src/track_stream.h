@@ -0,0 +1,120 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <set>
+#include <utility>
+#include <vector>
+#include "chunked_maze.h"
+#include "maze_structs.h"
+
+/**
+ * @brief Keeps a window of chunks of a ChunkedMaze around a moving robot and
+ * writes the geometry changes as a text delta stream.
+ *
+ * The window is the square of chunks within radius of the robot's chunk,
+ * plus the same square around the chunk `ahead` chunks further in the
+ * direction the robot last moved to another chunk. The direction only
+ * changes when the robot's chunk changes, so jitter inside a chunk or a
+ * stop keep the window as it is. Chunks entering the window are sent with
+ * their polygons, chunks leaving it are removed, so once the robot has left
+ * its first chunk the number of active chunks stays constant however long
+ * it drives.
+ *
+ * Stream format, one record per line:
+ *   chunks <chunkSize>                  header
+ *   add <cx> <cy> <polygons>            followed by one line per polygon:
+ *   <x0> <y0> <x1> <y1> ...             coordinates of the polygon
+ *   remove <cx> <cy>
+ *   sync <x> <y> <active chunks>        end of the update for a position
+ */
+template <class Rng>
+class TrackStreamer {
+public:
+    /**
+     * @param maze The unbounded maze, its cache should hold at least the window.
+     * @param out The delta stream (file or pipe).
+     * @param radius Chunks kept around the robot in every direction.
+     * @param ahead Chunks the window reaches ahead in the direction of motion.
+     */
+    TrackStreamer(ChunkedMaze<Rng>& maze, std::ostream& out, int radius, int ahead)
+        : maze_(maze), out_(out), radius_(radius), ahead_(ahead) {
+        out_ << std::fixed << std::setprecision(5);
+        out_ << "chunks " << maze_.chunkSize() << "\n";
+    }
+
+    size_t activeChunks() const { return active_.size(); }
+
+    /**
+     * @brief Moves the robot to a new position (in cells) and writes the
+     * resulting deltas, followed by a sync record.
+     */
+    void moveTo(double x, double y) {
+        int64_t cx = maze_.chunkCoordinate(static_cast<int64_t>(std::floor(x)));
+        int64_t cy = maze_.chunkCoordinate(static_cast<int64_t>(std::floor(y)));
+        if (hasPosition_ && (cx != lastCx_ || cy != lastCy_)) {
+            dirX_ = (cx > lastCx_) - (cx < lastCx_);
+            dirY_ = (cy > lastCy_) - (cy < lastCy_);
+        }
+        hasPosition_ = true;
+        lastCx_ = cx;
+        lastCy_ = cy;
+
+        std::set<ChunkId> wanted;
+        addSquare(wanted, cx, cy);
+        if (dirX_ != 0 || dirY_ != 0) addSquare(wanted, cx + dirX_ * ahead_, cy + dirY_ * ahead_);
+        for (auto it = active_.begin(); it != active_.end();) {
+            if (wanted.count(*it)) {
+                ++it;
+                continue;
+            }
+            out_ << "remove " << it->first << " " << it->second << "\n";
+            it = active_.erase(it);
+        }
+        for (const ChunkId& id : wanted) {
+            if (active_.insert(id).second) writeChunk(id.first, id.second);
+        }
+        out_ << "sync " << x << " " << y << " " << active_.size() << "\n";
+        out_.flush();
+    }
+
+private:
+    using ChunkId = std::pair<int64_t, int64_t>;
+
+    void addSquare(std::set<ChunkId>& chunks, int64_t cx, int64_t cy) const {
+        for (int64_t y = cy - radius_; y <= cy + radius_; ++y) {
+            for (int64_t x = cx - radius_; x <= cx + radius_; ++x) chunks.insert({x, y});
+        }
+    }
+
+    void writeChunk(int64_t cx, int64_t cy) {
+        const int64_t size = maze_.chunkSize();
+        polygons_.clear();
+        for (int64_t y = cy * size; y < (cy + 1) * size; ++y) {
+            for (int64_t x = cx * size; x < (cx + 1) * size; ++x) maze_.addPolygons(x, y, polygons_);
+        }
+        out_ << "add " << cx << " " << cy << " " << polygons_.size() << "\n";
+        for (const Mazepolygon poly : polygons_) {
+            bool first = true;
+            for (const auto& c : poly.coordinates) {
+                out_ << (first ? "" : " ") << c.x << " " << c.y;
+                first = false;
+            }
+            out_ << "\n";
+        }
+    }
+
+    ChunkedMaze<Rng>& maze_;
+    std::ostream& out_;
+    int radius_;
+    int ahead_;
+    std::set<ChunkId> active_;
+    PolygonStore polygons_;
+    bool hasPosition_ = false;
+    int64_t lastCx_ = 0;
+    int64_t lastCy_ = 0;
+    // direction of the last change of chunk, kept while the robot stays in a chunk
+    int dirX_ = 0;
+    int dirY_ = 0;
+};
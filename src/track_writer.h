@@ -0,0 +1,305 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <vector>
+#include "maze_structs.h"
+
+/**
+ * Output writers for the generated track.
+ *
+ * The writers receive the track polygon by polygon and node by node and
+ * stream everything to disk right away. Parts that have to appear later in
+ * the file are spooled into temporary files next to the output and appended
+ * by finish(), so memory does not grow with the size of the track.
+ *
+ * state() captures the written byte counts; a writer constructed with such
+ * a state truncates its files to it and continues as if it had never
+ * stopped, which is how checkpoints resume the output.
+ */
+
+// bounds for tiles so they dont overlap
+struct Bounds {
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+    void update(float x, float y) {
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+    float width() const { return maxX - minX; }
+    float height() const { return maxY - minY; }
+};
+
+/**
+ * @brief Temporary file that is written first and copied into the final
+ * output afterwards.
+ */
+class SpoolFile {
+public:
+    /**
+     * @param path The temporary file.
+     * @param resumeAt Size to truncate an existing file to and append from,
+     *        -1 to start a new file.
+     */
+    explicit SpoolFile(const std::string& path, int64_t resumeAt = -1) : path_(path) {
+        if (resumeAt >= 0) {
+            std::filesystem::resize_file(path, static_cast<uintmax_t>(resumeAt));
+            file_.open(path, std::ios::in | std::ios::out);
+            file_.seekp(0, std::ios::end);
+        } else {
+            file_.open(path, std::ios::in | std::ios::out | std::ios::trunc);
+        }
+        file_ << std::fixed << std::setprecision(5);
+    }
+    ~SpoolFile() {
+        file_.close();
+        std::remove(path_.c_str());
+    }
+
+    /**
+     * @brief Flushes the file and returns the number of bytes written.
+     */
+    int64_t size() {
+        file_.flush();
+        return static_cast<int64_t>(file_.tellp());
+    }
+
+    std::ostream& stream() { return file_; }
+
+    void copyTo(std::ostream& out) {
+        file_.flush();
+        file_.seekg(0);
+        if (file_.peek() != std::char_traits<char>::eof()) out << file_.rdbuf();
+    }
+
+private:
+    std::string path_;
+    std::fstream file_;
+};
+
+/**
+ * @brief Writes the C++ loader that fills MazeGenerator::polygons and
+ * MazeGenerator::solutionGraph from static flat arrays.
+ */
+class LoaderWriter {
+public:
+    /**
+     * @brief Byte sizes of the output and the spool files plus the counters,
+     * everything needed to continue writing.
+     */
+    struct State {
+        int64_t outBytes;
+        int64_t partBytes[4];
+        uint64_t coordinateCount;
+        uint64_t polygonCount;
+        uint64_t nodeCount;
+        uint64_t neighborCount;
+    };
+
+    /**
+     * @param filename The generated .cpp file.
+     * @param resume State of an interrupted writer to continue from, nullptr
+     *        for a new file.
+     */
+    explicit LoaderWriter(const std::string& filename, const State* resume = nullptr)
+        : polygonOffsets_(filename + ".part0", resume ? resume->partBytes[0] : -1),
+          nodeCoordinates_(filename + ".part1", resume ? resume->partBytes[1] : -1),
+          nodeOffsets_(filename + ".part2", resume ? resume->partBytes[2] : -1),
+          nodeNeighbors_(filename + ".part3", resume ? resume->partBytes[3] : -1) {
+        if (resume) {
+            std::filesystem::resize_file(filename, static_cast<uintmax_t>(resume->outBytes));
+            out_.open(filename, std::ios::app);
+            out_ << std::fixed << std::setprecision(5);
+            coordinateCount_ = resume->coordinateCount;
+            polygonCount_ = resume->polygonCount;
+            nodeCount_ = resume->nodeCount;
+            neighborCount_ = resume->neighborCount;
+            return;
+        }
+        out_.open(filename);
+        out_ << std::fixed << std::setprecision(5);
+        out_ << "#include <iostream>\n#include <list>\n#include <cmath>\n#include <vector>\n#include <unordered_map>\n\n#include \"maze_generator.h\"\n\n";
+        out_ << "void MazeGenerator::generateMaze() {\n";
+        // polygons as flat coordinate and offset arrays, one polygon per line
+        out_ << "    static const MazeCoordinate polygonCoordinates[] = {\n";
+        writeIndex(polygonOffsets_.stream(), 0, 0);
+        writeIndex(nodeOffsets_.stream(), 0, 0);
+    }
+
+    /**
+     * @brief Flushes all files and returns the state to resume from.
+     */
+    State state() {
+        out_.flush();
+        return State{static_cast<int64_t>(out_.tellp()),
+                     {polygonOffsets_.size(), nodeCoordinates_.size(), nodeOffsets_.size(), nodeNeighbors_.size()},
+                     coordinateCount_, polygonCount_, nodeCount_, neighborCount_};
+    }
+
+    bool good() const { return out_.good(); }
+    size_t polygonCount() const { return polygonCount_; }
+
+    void addPolygon(const MazeCoordinate* coords, size_t count) {
+        out_ << "        ";
+        for (size_t i = 0; i < count; ++i) {
+            out_ << "{" << coords[i].x << "f, " << coords[i].y << "f}, ";
+        }
+        out_ << "\n";
+        coordinateCount_ += count;
+        ++polygonCount_;
+        writeIndex(polygonOffsets_.stream(), polygonCount_, coordinateCount_);
+    }
+
+    /**
+     * @brief Appends the next solution graph node, nodes have to be added in
+     * index order.
+     */
+    void addNode(MazeCoordinate coord, const uint64_t* neighbors, size_t count) {
+        nodeCoordinates_.stream() << (nodeCount_ % 8 == 0 ? "\n        " : "")
+                                  << "{" << coord.x << "f, " << coord.y << "f}, ";
+        for (size_t i = 0; i < count; ++i) {
+            writeIndex(nodeNeighbors_.stream(), neighborCount_++, neighbors[i]);
+        }
+        ++nodeCount_;
+        writeIndex(nodeOffsets_.stream(), nodeCount_, neighborCount_);
+    }
+
+    void finish() {
+        // zero-length arrays are ill-formed, empty arrays get one unused
+        // element, the counts passed to assign() stay exact
+        if (coordinateCount_ == 0) out_ << "        {0.0f, 0.0f},\n";
+        out_ << "    };\n";
+        out_ << "    static const uint64_t polygonOffsets[] = {";
+        polygonOffsets_.copyTo(out_);
+        out_ << "\n    };\n";
+        out_ << "    polygons.assign(polygonCoordinates, " << coordinateCount_
+             << ", polygonOffsets, " << polygonCount_ << ");\n";
+        // solution graph as node coordinates, neighbour offsets and neighbour indices
+        out_ << "    static const MazeCoordinate nodeCoordinates[] = {";
+        nodeCoordinates_.copyTo(out_);
+        if (nodeCount_ == 0) out_ << "\n        {0.0f, 0.0f},";
+        out_ << "\n    };\n";
+        out_ << "    static const uint64_t nodeOffsets[] = {";
+        nodeOffsets_.copyTo(out_);
+        out_ << "\n    };\n";
+        out_ << "    static const uint64_t nodeNeighbors[] = {";
+        nodeNeighbors_.copyTo(out_);
+        if (neighborCount_ == 0) out_ << "\n        0,";
+        out_ << "\n    };\n";
+        out_ << "    solutionGraph.assign(nodeCoordinates, " << nodeCount_ << ", nodeOffsets, nodeNeighbors, "
+             << neighborCount_ << ");\n";
+        out_ << "}\n";
+        out_.close();
+    }
+
+private:
+    // 16 values per line
+    static void writeIndex(std::ostream& out, uint64_t position, uint64_t value) {
+        out << (position % 16 == 0 ? "\n        " : "") << value << ", ";
+    }
+
+    std::ofstream out_;
+    SpoolFile polygonOffsets_;
+    SpoolFile nodeCoordinates_;
+    SpoolFile nodeOffsets_;
+    SpoolFile nodeNeighbors_;
+    uint64_t coordinateCount_ = 0;
+    uint64_t polygonCount_ = 0;
+    uint64_t nodeCount_ = 0;
+    uint64_t neighborCount_ = 0;
+};
+
+/**
+ * @brief Writes the SVG visualisation with grid, solution edges and polygons.
+ *
+ * The view box depends on the polygon bounds, so edges and polygons are
+ * spooled and the header is written by finish().
+ */
+class SvgWriter {
+public:
+    /**
+     * @brief Byte sizes of the spool files and the bounds so far.
+     */
+    struct State {
+        int64_t partBytes[2];
+        Bounds bounds;
+    };
+
+    /**
+     * @param filename The SVG file.
+     * @param width The grid width.
+     * @param height The grid height.
+     * @param resume State of an interrupted writer to continue from, nullptr
+     *        for a new file.
+     */
+    SvgWriter(const std::string& filename, int width, int height, const State* resume = nullptr)
+        : filename_(filename), width_(width), height_(height),
+          edges_(filename + ".part0", resume ? resume->partBytes[0] : -1),
+          polygons_(filename + ".part1", resume ? resume->partBytes[1] : -1) {
+        if (resume) bounds_ = resume->bounds;
+        edges_.stream() << std::defaultfloat << std::setprecision(6);
+        polygons_.stream() << std::defaultfloat << std::setprecision(6);
+    }
+
+    /**
+     * @brief Flushes the spool files and returns the state to resume from.
+     */
+    State state() { return State{{edges_.size(), polygons_.size()}, bounds_}; }
+
+    void addEdge(float x1, float y1, float x2, float y2) {
+        edges_.stream() << "        <line x1=\"" << x1 << "\" y1=\"" << y1 << "\" x2=\"" << x2 << "\" y2=\"" << y2 << "\" />\n";
+    }
+
+    void addPolygon(const MazeCoordinate* coords, size_t count) {
+        if (count == 0) return;
+        std::ostream& svg = polygons_.stream();
+        svg << "    <path d=\"M ";
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0) svg << " L ";
+            svg << coords[i].x << "," << coords[i].y;
+            bounds_.update(coords[i].x, coords[i].y);
+        }
+        svg << " Z\" fill=\"#333333\" stroke=\"none\"/>\n";
+    }
+
+    void finish() {
+        std::ofstream svg(filename_);
+        char header[512];
+        snprintf(header, sizeof(header), "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"%f %f %f %f\">\n    <rect width=\"100%%\" height=\"100%%\" fill=\"#f8f8f8\"/>\n", 1000, 1000, bounds_.minX, bounds_.minY, bounds_.width(), bounds_.height());
+        svg << header;
+        // draw grid
+        svg << "    <g stroke=\"#bbb\" stroke-width=\"0.02\">\n";
+        for (int i = 0; i <= width_; ++i) {
+            svg << "        <line x1=\"" << i << "\" y1=\"0\" x2=\"" << i << "\" y2=\"" << height_ << "\" />\n";
+        }
+        for (int i = 0; i <= height_; ++i) {
+            svg << "        <line x1=\"0\" y1=\"" << i << "\" x2=\"" << width_ << "\" y2=\"" << i << "\" />\n";
+        }
+        svg << "    </g>\n";
+        svg << "    <circle cx=\"0\" cy=\"0\" r=\"0.2\" fill=\"red\"/>\n";
+        // solutiongraph lines
+        svg << "    <g stroke=\"#d22\" stroke-width=\"0.05\">\n";
+        edges_.copyTo(svg);
+        svg << "    </g>\n";
+        polygons_.copyTo(svg);
+        svg << "</svg>";
+        svg.close();
+    }
+
+private:
+    std::string filename_;
+    int width_;
+    int height_;
+    Bounds bounds_;
+    SpoolFile edges_;
+    SpoolFile polygons_;
+};
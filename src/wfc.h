@@ -0,0 +1,536 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "maze_algorithms.h"
+#include "maze_grid.h"
+#include "maze_structs.h"
+#include "parallel.h"
+#include "random.h"
+#include "tileset.h"
+
+/**
+ * @brief The tiles a grid cell can still take during wave function collapse.
+ * @var collapsed: only one option is left
+ * @var options: the remaining tiles as bitset over the tile indices
+ */
+struct Cell {
+    bool collapsed = false;
+    TileMask options;
+};
+
+/**
+ * @brief Tile indices of a grid in row-major order, -1 for none.
+ */
+struct TileGrid {
+    TileGrid(int width, int height) : width(width), height(height), tiles(static_cast<size_t>(width) * height, -1) {}
+
+    int& at(int x, int y) { return tiles[static_cast<size_t>(y) * width + x]; }
+    int at(int x, int y) const { return tiles[static_cast<size_t>(y) * width + x]; }
+
+    int width;
+    int height;
+    std::vector<int> tiles;
+};
+
+/**
+ * @brief Opens the walls of the maze between cells whose shared edge is not
+ * closed, so hash and solution graph follow the tiles.
+ */
+inline void applyTileWalls(const Tileset& tileset, const TileGrid& grid, MazeGrid& maze) {
+    const int closed = tileset.edgeId("X");
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
+            const Tile& t = tileset.tiles[grid.at(x, y)];
+            if (x + 1 < grid.width && t.edgeIds[0] != closed) maze.removeWall(x, y, 0);
+            if (y + 1 < grid.height && t.edgeIds[1] != closed) maze.removeWall(x, y, 1);
+        }
+    }
+}
+
+/**
+ * @brief Wave function collapse over the edge labels of a tileset.
+ *
+ * Every cell starts with all tiles as options, border cells only with the
+ * tiles whose outward edges carry the boundary label, closed ("X") unless
+ * set otherwise. The cell with the lowest entropy is taken from a min heap
+ * (ties broken by a per-cell random key) and collapsed to a random option.
+ * The change is propagated with a worklist: a neighbour in direction d
+ * keeps only the options contained in validNeighbors[d] of a remaining
+ * option of the cell.
+ *
+ * Domains are TileMask bitsets, so restricting a neighbour is one AND over
+ * a few words. The tiles allowed next to a domain are the OR of the
+ * precomputed validNeighbors of its tiles, or, for large domains, the OR of
+ * the tiles carrying one of the labels present on the domain's edge, which
+ * costs one intersection test per edge label instead of one OR per tile.
+ * The entropy of every cell is cached and updated from the removed tiles
+ * only.
+ *
+ * A cell without options is a contradiction. Every change of a cell is
+ * recorded on a trail, so the solver undoes everything since the last
+ * decision, bans the tile chosen there and propagates again, going back
+ * further when the ban itself fails.
+ *
+ * Edges match if they carry the same label, so tilesets can use any labels;
+ * for the maze walls and the solution graph every label except "X" is open.
+ */
+class WaveFunctionCollapse {
+public:
+    WaveFunctionCollapse(const Tileset& tileset, int width, int height)
+        : tileset_(tileset), width_(width), height_(height), closed_(tileset.edgeId("X")),
+          cells_(static_cast<size_t>(width) * height),
+          entropy_(cells_.size()), version_(cells_.size(), 0), queued_(cells_.size(), 0) {
+        for (const Tile& t : tileset.tiles) {
+            weights_.push_back(t.weight);
+            weightLogWeights_.push_back(t.weight * std::log(t.weight));
+            totalWeight_ += t.weight;
+        }
+        for (int d = 0; d < 4; ++d) boundary_[d].assign(d % 2 == 0 ? height : width, closed_);
+    }
+
+    /**
+     * @brief Sets the edge labels the cells along one side must carry on
+     * their outward edge, by default closed ("X").
+     *
+     * @param dir The side of the grid.
+     * @param labels One label id per cell along the side (rows for left and
+     *               right, columns for top and bottom), -1 leaves the edge free.
+     */
+    void setBoundary(int dir, std::vector<int> labels) { boundary_[dir] = std::move(labels); }
+
+    /**
+     * @brief Assigns a tile to every cell.
+     *
+     * A search that keeps backtracking is usually stuck below an early bad
+     * decision, so it restarts from scratch after a number of backtracks
+     * that doubles with every restart.
+     *
+     * @param rng The random engine.
+     * @param maxBacktracks Total number of undone decisions after which the search gives up.
+     * @return false if the tileset cannot fill the grid or no tiling was found in time.
+     */
+    template <class Rng>
+    bool run(Rng& rng, size_t maxBacktracks = 100000) {
+        size_t total = 0;
+        for (size_t limit = 64;; limit *= 2) {
+            limit = std::min(limit, maxBacktracks - total);
+            const bool solved = search(rng, limit);
+            total += backtracks_;
+            // a search that failed below its limit has tried every option
+            if (solved || backtracks_ < limit || total >= maxBacktracks) {
+                backtracks_ = total;
+                return solved;
+            }
+        }
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    size_t backtracks() const { return backtracks_; }
+
+    /**
+     * @brief The tile of a cell after a successful run.
+     */
+    int tile(int x, int y) const { return cells_[index(x, y)].options.nth(0); }
+
+    /**
+     * @brief Copies the tiles into a larger grid, cell (0, 0) goes to (x0, y0).
+     */
+    void copyTo(TileGrid& grid, int x0, int y0) const {
+        for (int y = 0; y < height_; ++y) {
+            for (int x = 0; x < width_; ++x) grid.at(x0 + x, y0 + y) = tile(x, y);
+        }
+    }
+
+private:
+    /**
+     * @brief Sums over the weights w of the options of a cell, the entropy
+     * is log(sum w) - sum(w log w) / sum w.
+     */
+    struct Entropy {
+        uint32_t count = 0;
+        double weight = 0;
+        double weightLogWeight = 0;
+
+        double value() const { return std::log(weight) - weightLogWeight / weight; }
+    };
+    struct Decision {
+        uint32_t cell;
+        int tile;
+        size_t trailSize;
+    };
+    struct TrailEntry {
+        uint32_t cell;
+        TileMask options;
+        Entropy entropy;
+    };
+    struct HeapEntry {
+        double entropy;
+        uint32_t noise;
+        uint32_t cell;
+        uint32_t version;
+
+        bool operator>(const HeapEntry& other) const {
+            return entropy != other.entropy ? entropy > other.entropy : noise > other.noise;
+        }
+    };
+
+    /**
+     * @brief One search from empty cells.
+     * @return false on a contradiction that cannot be resolved in maxBacktracks steps.
+     */
+    template <class Rng>
+    bool search(Rng& rng, size_t maxBacktracks) {
+        reset(rng());
+        if (!propagate()) return false;
+        while (true) {
+            const int cell = nextCell();
+            if (cell < 0) return true;
+            const int tile = chooseTile(cell, rng);
+            decisions_.push_back(Decision{static_cast<uint32_t>(cell), tile, trail_.size()});
+            TileMask chosen;
+            chosen.set(tile);
+            bool ok = restrict(cell, chosen) && propagate();
+            while (!ok) {
+                if (decisions_.empty() || backtracks_ == maxBacktracks) return false;
+                ++backtracks_;
+                Decision decision = decisions_.back();
+                decisions_.pop_back();
+                undo(decision.trailSize);
+                TileMask remaining = cells_[decision.cell].options;
+                remaining.reset(decision.tile);
+                ok = restrict(decision.cell, remaining) && propagate();
+            }
+        }
+    }
+
+    /**
+     * @brief Draws one of the options of a cell by the tile weights.
+     *
+     * While the options hold at least 1/16 of the total weight, tiles are
+     * drawn from the alias table of the tileset until one is an option,
+     * which takes 16 draws at most on average. Smaller domains are sampled
+     * by a scan over their weights.
+     */
+    template <class Rng>
+    int chooseTile(uint32_t cell, Rng& rng) const {
+        const TileMask& options = cells_[cell].options;
+        const Entropy& e = entropy_[cell];
+        if (tileset_.uniformWeights) return options.nth(uniformInt(rng, e.count));
+        if (e.weight * 16 >= totalWeight_) {
+            while (true) {
+                const uint32_t t = tileset_.tileWeights(rng);
+                if (options.test(t)) return static_cast<int>(t);
+            }
+        }
+        double r = static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0) * e.weight;
+        int chosen = -1;
+        options.forEach([&](size_t t) {
+            if (chosen >= 0 && r < 0) return;
+            chosen = static_cast<int>(t);
+            r -= weights_[t];
+        });
+        return chosen;
+    }
+
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * width_ + x; }
+
+    bool inside(int x, int y) const { return x >= 0 && x < width_ && y >= 0 && y < height_; }
+
+    Entropy entropyOf(const TileMask& options) const {
+        Entropy e;
+        options.forEach([&](size_t t) {
+            ++e.count;
+            e.weight += weights_[t];
+            e.weightLogWeight += weightLogWeights_[t];
+        });
+        return e;
+    }
+
+    void reset(uint64_t noiseSeed) {
+        noiseSeed_ = noiseSeed;
+        trail_.clear();
+        decisions_.clear();
+        heap_ = {};
+        backtracks_ = 0;
+        // only cells on the border start with fewer than all tiles
+        TileMask all;
+        for (const Tile& t : tileset_.tiles) all.set(t.index);
+        const Entropy allEntropy = entropyOf(all);
+        for (int y = 0; y < height_; ++y) {
+            for (int x = 0; x < width_; ++x) {
+                const uint32_t i = static_cast<uint32_t>(index(x, y));
+                Cell& cell = cells_[i];
+                cell.options = all;
+                for (int d = 0; d < 4; ++d) {
+                    if (inside(x + DIR_DX[d], y + DIR_DY[d])) continue;
+                    const int label = boundary_[d][d % 2 == 0 ? y : x];
+                    if (label >= 0) cell.options &= tileset_.tilesWithEdge[d][label];
+                }
+                entropy_[i] = cell.options == all ? allEntropy : entropyOf(cell.options);
+                cell.collapsed = entropy_[i].count == 1;
+                pushHeap(i);
+                enqueue(i);
+            }
+        }
+    }
+
+    void pushHeap(uint32_t cell) {
+        if (entropy_[cell].count < 2) return;
+        heap_.push(HeapEntry{entropy_[cell].value(), static_cast<uint32_t>(hashRandom(noiseSeed_, cell) >> 32), cell,
+                             version_[cell]});
+    }
+
+    void enqueue(uint32_t cell) {
+        if (queued_[cell]) return;
+        queued_[cell] = 1;
+        worklist_.push_back(cell);
+    }
+
+    /**
+     * @brief The uncollapsed cell with the lowest entropy, -1 if all cells
+     * are collapsed. Entries left behind by later changes are skipped.
+     */
+    int nextCell() {
+        while (!heap_.empty()) {
+            const HeapEntry& top = heap_.top();
+            if (!cells_[top.cell].collapsed && version_[top.cell] == top.version) return static_cast<int>(top.cell);
+            heap_.pop();
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Narrows the options of a cell to a subset, saving the old ones
+     * on the trail. The entropy sums are updated by subtracting the removed
+     * tiles, or recomputed if fewer tiles remain than were removed.
+     * @return false if no option is left.
+     */
+    bool restrict(uint32_t cell, const TileMask& options) {
+        Cell& c = cells_[cell];
+        Entropy& e = entropy_[cell];
+        trail_.push_back(TrailEntry{cell, c.options, e});
+        const TileMask removed = c.options ^ options;
+        c.options = options;
+        const uint32_t count = static_cast<uint32_t>(options.count());
+        if (count < e.count - count) {
+            e = entropyOf(options);
+        } else {
+            removed.forEach([&](size_t t) {
+                e.weight -= weights_[t];
+                e.weightLogWeight -= weightLogWeights_[t];
+            });
+            e.count = count;
+        }
+        c.collapsed = count == 1;
+        ++version_[cell];
+        if (count == 0) return false;
+        pushHeap(cell);
+        enqueue(cell);
+        return true;
+    }
+
+    /**
+     * @brief Restores the options of all cells changed after the trail had the given size.
+     */
+    void undo(size_t trailSize) {
+        while (trail_.size() > trailSize) {
+            const TrailEntry& entry = trail_.back();
+            Cell& c = cells_[entry.cell];
+            c.options = entry.options;
+            entropy_[entry.cell] = entry.entropy;
+            c.collapsed = entry.entropy.count == 1;
+            ++version_[entry.cell];
+            pushHeap(entry.cell);
+            trail_.pop_back();
+        }
+    }
+
+    /**
+     * @brief The tiles that may be placed in direction dir of a cell.
+     */
+    TileMask allowedNeighbors(uint32_t cell, int dir) const {
+        const TileMask& options = cells_[cell].options;
+        const auto& withEdge = tileset_.tilesWithEdge[dir];
+        const auto& facing = tileset_.tilesWithEdge[(dir + 2) % 4];
+        TileMask allowed;
+        if (entropy_[cell].count <= withEdge.size()) {
+            options.forEach([&](size_t t) { allowed |= tileset_.tiles[t].validNeighbors[dir]; });
+            return allowed;
+        }
+        for (size_t label = 0; label < withEdge.size(); ++label) {
+            if (options.intersects(withEdge[label])) allowed |= facing[label];
+        }
+        return allowed;
+    }
+
+    /**
+     * @brief Removes the options of the neighbours of all queued cells that
+     * no longer fit, until nothing changes.
+     * @return false on a contradiction, the worklist is empty afterwards.
+     */
+    bool propagate() {
+        bool ok = true;
+        while (ok && !worklist_.empty()) {
+            const uint32_t cell = worklist_.back();
+            worklist_.pop_back();
+            queued_[cell] = 0;
+            const int x = cell % width_, y = cell / width_;
+            for (int d = 0; d < 4 && ok; ++d) {
+                const int nx = x + DIR_DX[d], ny = y + DIR_DY[d];
+                if (!inside(nx, ny)) continue;
+                const uint32_t neighbor = static_cast<uint32_t>(index(nx, ny));
+                const TileMask kept = cells_[neighbor].options & allowedNeighbors(cell, d);
+                if (kept != cells_[neighbor].options) ok = restrict(neighbor, kept);
+            }
+        }
+        for (uint32_t cell : worklist_) queued_[cell] = 0;
+        worklist_.clear();
+        return ok;
+    }
+
+    const Tileset& tileset_;
+    int width_;
+    int height_;
+    int closed_;
+    std::array<std::vector<int>, 4> boundary_;
+    std::vector<double> weights_;
+    std::vector<double> weightLogWeights_;
+    double totalWeight_ = 0;
+    std::vector<Cell> cells_;
+    std::vector<Entropy> entropy_;
+    std::vector<uint32_t> version_;
+    std::vector<uint8_t> queued_;
+    std::vector<uint32_t> worklist_;
+    std::vector<TrailEntry> trail_;
+    std::vector<Decision> decisions_;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap_;
+    uint64_t noiseSeed_ = 0;
+    size_t backtracks_ = 0;
+};
+
+/**
+ * @brief Solves a rectangle of a tile grid with wave function collapse and
+ * writes the tiles into the grid.
+ *
+ * Sides on the grid border stay closed. Sides inside the grid either match
+ * the tiles next to the rectangle or, if matchNeighbors is false, are left
+ * free.
+ *
+ * @return false if no tiling of the rectangle fits its sides.
+ */
+template <class Rng>
+bool solveTileRegion(const Tileset& tileset, TileGrid& grid, const MazeRegion& region, Rng& rng,
+                     bool matchNeighbors) {
+    WaveFunctionCollapse wfc(tileset, region.x1 - region.x0, region.y1 - region.y0);
+    const int closed = tileset.edgeId("X");
+    for (int d = 0; d < 4; ++d) {
+        const int length = d % 2 == 0 ? wfc.height() : wfc.width();
+        std::vector<int> labels(length);
+        for (int i = 0; i < length; ++i) {
+            // the cell outside the i-th cell of the side
+            const int x = d % 2 == 0 ? (d == 0 ? region.x1 : region.x0 - 1) : region.x0 + i;
+            const int y = d % 2 == 0 ? region.y0 + i : (d == 1 ? region.y1 : region.y0 - 1);
+            if (x < 0 || x >= grid.width || y < 0 || y >= grid.height) labels[i] = closed;
+            else labels[i] = matchNeighbors ? tileset.tiles[grid.at(x, y)].edgeIds[(d + 2) % 4] : -1;
+        }
+        wfc.setBoundary(d, std::move(labels));
+    }
+    if (!wfc.run(rng)) return false;
+    wfc.copyTo(grid, region.x0, region.y0);
+    return true;
+}
+
+/**
+ * @brief Fills a tile grid with wave function collapse on several threads.
+ *
+ * The grid is cut into regions of regionSize x regionSize cells, which are
+ * solved concurrently with free edges towards each other. Wherever two
+ * cells across a region seam do not match afterwards, a window of
+ * seamMargin cells on both sides of the seam is solved again with the tiles
+ * around it fixed, first along the vertical seams, then along the
+ * horizontal ones. Windows on the same seam are merged when they touch, and
+ * the margin is kept below half the region size, so the windows of a pass
+ * never touch each other and are solved concurrently as well. A window
+ * without solution is retried on its own with a growing margin.
+ *
+ * Every region and window draws from its own random stream, the result
+ * does not depend on the number of threads.
+ *
+ * @return false if the tileset cannot fill the grid.
+ */
+template <class Rng>
+bool generateTilesParallel(const Tileset& tileset, TileGrid& grid, Rng& rng, const MazeAlgorithmOptions& options,
+                           int seamMargin = 4) {
+    const int W = grid.width, H = grid.height;
+    const int size = std::max(8, options.regionSize);
+    const int cols = (W + size - 1) / size, rows = (H + size - 1) / size;
+    std::vector<uint64_t> seeds(static_cast<size_t>(cols) * rows);
+    for (auto& s : seeds) s = rng();
+    const uint64_t seamSeed = rng();
+
+    std::atomic<bool> failed{false};
+    parallelFor(seeds.size(), options.threads, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end && !failed; ++r) {
+            const int x0 = static_cast<int>(r % cols) * size, y0 = static_cast<int>(r / cols) * size;
+            Rng regionRng(seeds[r]);
+            MazeRegion region{x0, y0, std::min(W, x0 + size), std::min(H, y0 + size)};
+            if (!solveTileRegion(tileset, grid, region, regionRng, false)) failed = true;
+        }
+    });
+    if (failed) return false;
+
+    const int margin = std::max(1, std::min(seamMargin, (size - 1) / 2));
+    auto label = [&](int x, int y, int dir) { return tileset.tiles[grid.at(x, y)].edgeIds[dir]; };
+    // axis 0: seams between region columns, axis 1: seams between region rows
+    for (int axis = 0; axis < 2; ++axis) {
+        const int seams = axis == 0 ? cols : rows;
+        const int length = axis == 0 ? H : W;
+        const int across = axis == 0 ? W : H;
+        std::vector<MazeRegion> windows;
+        for (int s = 1; s < seams; ++s) {
+            const int seam = s * size; // first cell after the seam
+            const size_t first = windows.size();
+            for (int i = 0; i < length; ++i) {
+                const int x = axis == 0 ? seam : i, y = axis == 0 ? i : seam;
+                if (axis == 0 ? label(x - 1, y, 0) == label(x, y, 2) : label(x, y - 1, 1) == label(x, y, 3)) continue;
+                const int lo = std::max(0, i - margin), hi = std::min(length, i + margin + 1);
+                const int a0 = std::max(0, seam - margin), a1 = std::min(across, seam + margin);
+                if (windows.size() > first) {
+                    MazeRegion& last = windows.back();
+                    int& lastHi = axis == 0 ? last.y1 : last.x1;
+                    if (lastHi >= lo) {
+                        lastHi = hi;
+                        continue;
+                    }
+                }
+                windows.push_back(axis == 0 ? MazeRegion{a0, lo, a1, hi} : MazeRegion{lo, a0, hi, a1});
+            }
+        }
+        auto windowSeed = [&](size_t i) { return hashRandom(seamSeed, (static_cast<uint64_t>(axis) << 32) | i); };
+        std::vector<uint8_t> solved(windows.size(), 0);
+        parallelFor(windows.size(), options.threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Rng windowRng(windowSeed(i));
+                solved[i] = solveTileRegion(tileset, grid, windows[i], windowRng, true);
+            }
+        });
+        for (size_t i = 0; i < windows.size(); ++i) {
+            MazeRegion window = windows[i];
+            for (int grow = margin; !solved[i]; grow *= 2) {
+                if (window.x0 == 0 && window.y0 == 0 && window.x1 == W && window.y1 == H) return false;
+                window = MazeRegion{std::max(0, window.x0 - grow), std::max(0, window.y0 - grow),
+                                    std::min(W, window.x1 + grow), std::min(H, window.y1 + grow)};
+                Rng windowRng(hashRandom(windowSeed(i), grow));
+                solved[i] = solveTileRegion(tileset, grid, window, windowRng, true);
+            }
+        }
+    }
+    return true;
+}
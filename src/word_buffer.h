@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define WORD_BUFFER_MMAP 1
+#endif
+
+/**
+ * @brief Fixed-size array of zeroed 64 bit words, either on the heap or in
+ * a memory-mapped file.
+ *
+ * Heap buffers come from calloc, so pages that are never written are not
+ * resident. File buffers map a sparse file of the requested size; the
+ * kernel writes dirty pages back and evicts them under memory pressure,
+ * which lets grids grow beyond the available RAM. The file is removed when
+ * the buffer is destroyed.
+ */
+class WordBuffer {
+public:
+    WordBuffer() = default;
+
+    /**
+     * @param words Number of words.
+     * @param path Backing file, empty for a heap buffer.
+     * @throws std::runtime_error if the memory or the file cannot be allocated.
+     */
+    explicit WordBuffer(size_t words, const std::string& path = "") : size_(words), path_(path) {
+        if (words == 0) return;
+        if (path.empty()) {
+            data_ = static_cast<uint64_t*>(std::calloc(words, sizeof(uint64_t)));
+            if (!data_) throw std::runtime_error("Out of memory");
+            return;
+        }
+#ifdef WORD_BUFFER_MMAP
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(words * sizeof(uint64_t))) != 0) {
+            if (fd >= 0) ::close(fd);
+            throw std::runtime_error("Cannot create storage file " + path);
+        }
+        void* p = ::mmap(nullptr, words * sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            ::unlink(path.c_str());
+            throw std::runtime_error("Cannot map storage file " + path);
+        }
+        data_ = static_cast<uint64_t*>(p);
+        mapped_ = true;
+#else
+        throw std::runtime_error("Memory-mapped storage is not supported on this platform");
+#endif
+    }
+
+    WordBuffer(const WordBuffer&) = delete;
+    WordBuffer& operator=(const WordBuffer&) = delete;
+    WordBuffer(WordBuffer&& other) noexcept { swap(other); }
+    WordBuffer& operator=(WordBuffer&& other) noexcept {
+        WordBuffer tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    ~WordBuffer() {
+        if (!data_) return;
+#ifdef WORD_BUFFER_MMAP
+        if (mapped_) {
+            ::munmap(data_, size_ * sizeof(uint64_t));
+            ::unlink(path_.c_str());
+            return;
+        }
+#endif
+        std::free(data_);
+    }
+
+    size_t size() const { return size_; }
+    bool mapped() const { return mapped_; }
+
+    uint64_t* data() { return data_; }
+    const uint64_t* data() const { return data_; }
+    uint64_t* begin() { return data_; }
+    uint64_t* end() { return data_ + size_; }
+    const uint64_t* begin() const { return data_; }
+    const uint64_t* end() const { return data_ + size_; }
+    uint64_t& operator[](size_t i) { return data_[i]; }
+    const uint64_t& operator[](size_t i) const { return data_[i]; }
+
+private:
+    void swap(WordBuffer& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(path_, other.path_);
+        std::swap(mapped_, other.mapped_);
+    }
+
+    uint64_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::string path_;
+    bool mapped_ = false;
+};